@@ -41,6 +41,7 @@ inline QString Parity_toString(QSerialPort::Parity parity)
 ///
 MainStatusBar::MainStatusBar(const ModbusClient& client, QMdiArea* parent)
     : QStatusBar(parent)
+    ,_modbusClient(client)
     ,_mdiArea(parent)
 {
     Q_ASSERT(_mdiArea != nullptr);
@@ -127,6 +128,7 @@ void MainStatusBar::updateNumberOfPolls()
     }
 
     _labelPolls->setText(QString(tr("Polls: %1")).arg(polls));
+    updateQueueWaitInfo();
 }
 
 ///
@@ -144,6 +146,23 @@ void MainStatusBar::updateValidSlaveResponses()
     _labelResps->setText(QString(tr("Resps: %1")).arg(resps));
 }
 
+///
+/// \brief MainStatusBar::updateQueueWaitInfo
+///
+void MainStatusBar::updateQueueWaitInfo()
+{
+    const auto interactive = _modbusClient.queueWaitStatistics(RequestPriority::Interactive);
+    const auto active = _modbusClient.queueWaitStatistics(RequestPriority::Active);
+    const auto background = _modbusClient.queueWaitStatistics(RequestPriority::Background);
+
+    _labelPolls->setToolTip(QString(tr("Queue wait avg/max (ms)\nInteractive: %1/%2\nActive window: %3/%4\nBackground: %5/%6\nPending: %7\nPending writes: %8\nCollapsed writes: %9")).arg(
+                            QString::number(interactive.average()), QString::number(interactive.Max),
+                            QString::number(active.average()), QString::number(active.Max),
+                            QString::number(background.average()), QString::number(background.Max),
+                            QString::number(_modbusClient.pendingRequests()),
+                            QString::number(_modbusClient.pendingWrites()),
+                            QString::number(_modbusClient.collapsedWrites())));
+}
 
 ///
 /// \brief MainStatusBar::updateConnectionInfo
@@ -24,8 +24,10 @@ protected:
 
 private:
     void updateConnectionInfo(const ConnectionDetails& cd, bool connecting);
+    void updateQueueWaitInfo();
 
 private:
+    const ModbusClient& _modbusClient;
     QMdiArea* _mdiArea;
     QLabel* _labelPolls;
     QLabel* _labelResps;
@@ -41,6 +41,7 @@ void SimulationModeComboBox::setup(QModbusDataUnit::RegisterType type)
         case QModbusDataUnit::DiscreteInputs:
             addItem(tr("Random"), QVariant::fromValue(SimulationMode::Random));
             addItem(tr("Toggle"), QVariant::fromValue(SimulationMode::Toggle));
+            addItem(tr("Expression"), QVariant::fromValue(SimulationMode::Expression));
         break;
 
         case QModbusDataUnit::HoldingRegisters:
@@ -48,6 +49,13 @@ void SimulationModeComboBox::setup(QModbusDataUnit::RegisterType type)
             addItem(tr("Random"), QVariant::fromValue(SimulationMode::Random));
             addItem(tr("Increment"), QVariant::fromValue(SimulationMode::Increment));
             addItem(tr("Decrement"), QVariant::fromValue(SimulationMode::Decrement));
+            addItem(tr("Sine"), QVariant::fromValue(SimulationMode::Sine));
+            addItem(tr("Triangle"), QVariant::fromValue(SimulationMode::Triangle));
+            addItem(tr("Square"), QVariant::fromValue(SimulationMode::Square));
+            addItem(tr("Ramp"), QVariant::fromValue(SimulationMode::Ramp));
+            addItem(tr("Noise"), QVariant::fromValue(SimulationMode::Noise));
+            addItem(tr("Profile"), QVariant::fromValue(SimulationMode::Profile));
+            addItem(tr("Expression"), QVariant::fromValue(SimulationMode::Expression));
         break;
 
         default:
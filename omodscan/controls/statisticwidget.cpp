@@ -10,6 +10,7 @@ StatisticWidget::StatisticWidget(QWidget *parent) :
     , ui(new Ui::StatisticWidget)
     ,_numberOfPolls(0)
     ,_validSlaveResponses(0)
+    ,_changed(false)
 {
     ui->setupUi(this);
 }
@@ -42,9 +43,7 @@ void StatisticWidget::changeEvent(QEvent* event)
 void StatisticWidget::increaseNumberOfPolls()
 {
     _numberOfPolls++;
-    updateStatistic();
-
-    emit numberOfPollsChanged(_numberOfPolls);
+    _changed = true;
 }
 
 ///
@@ -53,9 +52,7 @@ void StatisticWidget::increaseNumberOfPolls()
 void StatisticWidget::increaseValidSlaveResponses()
 {
    _validSlaveResponses++;
-   updateStatistic();
-
-   emit validSlaveResposesChanged(_validSlaveResponses);
+   _changed = true;
 }
 
 ///
@@ -65,7 +62,23 @@ void StatisticWidget::resetCtrs()
 {
     _numberOfPolls = 0;
     _validSlaveResponses = 0;
+    _changed = false;
+
+    updateStatistic();
+
+    emit numberOfPollsChanged(_numberOfPolls);
+    emit validSlaveResposesChanged(_validSlaveResponses);
+}
+
+///
+/// \brief StatisticWidget::refresh
+///
+void StatisticWidget::refresh()
+{
+    if(!_changed)
+        return;
 
+    _changed = false;
     updateStatistic();
 
     emit numberOfPollsChanged(_numberOfPolls);
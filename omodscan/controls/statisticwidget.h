@@ -25,6 +25,8 @@ public:
     void increaseValidSlaveResponses();
     void resetCtrs();
 
+    void refresh();
+
 signals:
     void numberOfPollsChanged(uint value);
     void validSlaveResposesChanged(uint value);
@@ -45,6 +47,7 @@ private:
 private:
     uint _numberOfPolls;
     uint _validSlaveResponses;
+    bool _changed;
 };
 
 #endif // STATISTICWIDGET_H
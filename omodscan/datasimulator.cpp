@@ -1,14 +1,76 @@
+#include <cmath>
 #include <QRandomGenerator>
 #include "datasimulator.h"
 
+///
+/// \brief Max ticks a single timeout catches up on, the rest of a longer stall is skipped
+///
+static const quint64 MaxCatchUpTicks = 5;
+
+///
+/// \brief DataSimulator::SimulationTable::append
+/// \param id
+/// \param addr
+/// \param mode
+/// \param params
+/// \return row of the new point
+///
+int DataSimulator::SimulationTable::append(int id, quint16 addr, DataDisplayMode mode, const ModbusSimulationParams& params)
+{
+    Ids.push_back(id);
+    Addresses.push_back(addr);
+    Modes.push_back(mode);
+    Params.push_back(params);
+    DueTicks.push_back(0);
+    Integers.push_back(0);
+    Reals.push_back(0);
+    Expressions.push_back(SimulationExpression());
+
+    return Ids.size() - 1;
+}
+
+///
+/// \brief DataSimulator::SimulationTable::removeAt
+/// \param row
+/// \return id of the point moved into the row, -1 if the last row was removed
+///
+int DataSimulator::SimulationTable::removeAt(int row)
+{
+    const int last = Ids.size() - 1;
+    if(row != last)
+    {
+        Ids[row] = Ids[last];
+        Addresses[row] = Addresses[last];
+        Modes[row] = Modes[last];
+        Params[row] = Params[last];
+        DueTicks[row] = DueTicks[last];
+        Integers[row] = Integers[last];
+        Reals[row] = Reals[last];
+        Expressions[row] = Expressions[last];
+    }
+
+    Ids.removeLast();
+    Addresses.removeLast();
+    Modes.removeLast();
+    Params.removeLast();
+    DueTicks.removeLast();
+    Integers.removeLast();
+    Reals.removeLast();
+    Expressions.removeLast();
+
+    return row != last ? Ids[row] : -1;
+}
+
 ///
 /// \brief DataSimulator::DataSimulator
 /// \param parent
 ///
 DataSimulator::DataSimulator(QObject* parent)
     : QObject{parent}
-    ,_elapsed(0)
+    ,_clockBase(0)
+    ,_nextPointId(0)
 {
+    _timer.setTimerType(Qt::PreciseTimer);
     connect(&_timer, &QTimer::timeout, this, &DataSimulator::on_timeout);
 }
 
@@ -20,6 +82,27 @@ DataSimulator::~DataSimulator()
     stopSimulations();
 }
 
+///
+/// \brief DataSimulator::tableKey
+/// \param type
+/// \param deviceId
+/// \return
+///
+quint32 DataSimulator::tableKey(QModbusDataUnit::RegisterType type, quint8 deviceId)
+{
+    return (quint32(deviceId) << 8) | quint32(type);
+}
+
+///
+/// \brief DataSimulator::intervalTicks
+/// \param params
+/// \return
+///
+quint64 DataSimulator::intervalTicks(const ModbusSimulationParams& params)
+{
+    return qMax<quint64>(1, params.Interval / TickInterval);
+}
+
 ///
 /// \brief DataSimulator::startSimulation
 /// \param mode
@@ -29,24 +112,44 @@ DataSimulator::~DataSimulator()
 ///
 void DataSimulator::startSimulation(DataDisplayMode mode, QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId, const ModbusSimulationParams& params)
 {
-    QVariant value;
+    removeSimulation({ type, addr, deviceId });
+
+    const auto key = tableKey(type, deviceId);
+    auto& table = _tables[key];
+    table.Type = type;
+    table.DeviceId = deviceId;
+
+    const int id = _nextPointId++;
+    const int row = table.append(id, addr, mode, params);
+    _points.insert(id, { key, row });
+    _pointIds.insert({ type, addr, deviceId }, id);
+
     switch (params.Mode)
     {
         case SimulationMode::Increment:
-            value = params.IncrementParams.Range.from();
-            emit dataSimulated(mode, type, addr, deviceId, value);
+            table.Integers[row] = static_cast<qint64>(params.IncrementParams.Range.from());
+            table.Reals[row] = params.IncrementParams.Range.from();
+            addSimulatedValue(table, row);
         break;
 
         case SimulationMode::Decrement:
-            value = params.DecrementParams.Range.to();
-            emit dataSimulated(mode, type, addr, deviceId, value);
+            table.Integers[row] = static_cast<qint64>(params.DecrementParams.Range.to());
+            table.Reals[row] = params.DecrementParams.Range.to();
+            addSimulatedValue(table, row);
+        break;
+
+        case SimulationMode::Expression:
+            table.Expressions[row].compile(params.ExpressionParams.Expression);
         break;
 
         default:
         break;
     }
 
-    _simulationMap.insert({ type, addr, deviceId}, { mode, params, value });
+    table.DueTicks[row] = _wheel.currentTick() + intervalTicks(params);
+    _wheel.schedule(id, table.DueTicks[row]);
+
+    flushSimulatedValues();
     resumeSimulations();
 
     emit simulationStarted(type, addr, deviceId);
@@ -59,17 +162,63 @@ void DataSimulator::startSimulation(DataDisplayMode mode, QModbusDataUnit::Regis
 ///
 void DataSimulator::stopSimulation(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId)
 {
-    _simulationMap.remove({ type, addr, deviceId});
+    removeSimulation({ type, addr, deviceId });
     emit simulationStopped(type, addr, deviceId);
 }
 
+///
+/// \brief DataSimulator::removeSimulation
+/// \param key
+///
+void DataSimulator::removeSimulation(const SimulationKey& key)
+{
+    const auto it = _pointIds.find(key);
+    if(it == _pointIds.end())
+        return;
+
+    // the wheel entry of the point is dropped lazily when it falls due
+    const auto ref = _points.take(it.value());
+    _pointIds.erase(it);
+
+    auto& table = _tables[ref.Table];
+    const int movedId = table.removeAt(ref.Row);
+    if(movedId >= 0)
+        _points[movedId].Row = ref.Row;
+
+    if(table.size() == 0)
+        _tables.remove(ref.Table);
+
+    // nothing left to simulate, the timer would only spin
+    if(_points.isEmpty())
+        pauseSimulations();
+}
+
 ///
 /// \brief DataSimulator::stopSimulations
 ///
 void DataSimulator::stopSimulations()
 {
     pauseSimulations();
-    _simulationMap.clear();
+    _tables.clear();
+    _points.clear();
+    _pointIds.clear();
+    _wheel.clear();
+}
+
+///
+/// \brief DataSimulator::updateRegisters
+/// \param deviceId
+/// \param data latest values read from the device, the operands of simulation expressions
+///
+void DataSimulator::updateRegisters(quint8 deviceId, const QModbusDataUnit& data)
+{
+    auto& image = _registers[tableKey(data.registerType(), deviceId)];
+    if(image.isEmpty())
+        image.resize(USHRT_MAX + 1);
+
+    const int count = qMin<int>(data.valueCount(), image.size() - data.startAddress());
+    for(int i = 0; i < count; i++)
+        image[data.startAddress() + i] = data.value(i);
 }
 
 ///
@@ -86,7 +235,12 @@ void DataSimulator::pauseSimulations()
 void DataSimulator::resumeSimulations()
 {
     if(!_timer.isActive())
-        _timer.start(_interval);
+    {
+        // the wheel carries on from where it was paused
+        _clockBase = _wheel.currentTick();
+        _clock.start();
+        _timer.start(TickInterval);
+    }
 }
 
 ///
@@ -95,11 +249,18 @@ void DataSimulator::resumeSimulations()
 void DataSimulator::restartSimulations()
 {
     pauseSimulations();
-    for(auto&& key : _simulationMap.keys())
+
+    QVector<QPair<SimulationKey, int>> points;
+    for(auto it = _pointIds.cbegin(); it != _pointIds.cend(); ++it)
+        points.push_back({ it.key(), it.value() });
+
+    for(auto&& p : points)
     {
-        const auto mode = _simulationMap[key].Mode;
-        const auto params = _simulationMap[key].Params;
-        startSimulation(mode, key.Type, key.Address,  key.DeviceId, params);
+        const auto ref = _points.value(p.second);
+        const auto& table = _tables[ref.Table];
+        const auto mode = table.Modes[ref.Row];
+        const auto params = table.Params[ref.Row];
+        startSimulation(mode, p.first.Type, p.first.Address, p.first.DeviceId, params);
     }
 }
 
@@ -111,8 +272,12 @@ void DataSimulator::restartSimulations()
 ///
 ModbusSimulationParams DataSimulator::simulationParams(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId) const
 {
-    const auto it = _simulationMap.find({type, addr, deviceId});
-    return (it != _simulationMap.end()) ? it->Params : ModbusSimulationParams();
+    const auto it = _pointIds.find({type, addr, deviceId});
+    if(it == _pointIds.end())
+        return ModbusSimulationParams();
+
+    const auto ref = _points.value(it.value());
+    return _tables.constFind(ref.Table)->Params[ref.Row];
 }
 
 ///
@@ -122,9 +287,14 @@ ModbusSimulationParams DataSimulator::simulationParams(QModbusDataUnit::Register
 ModbusSimulationMap DataSimulator::simulationMap(quint8 deviceId) const
 {
     ModbusSimulationMap map;
-    for(auto&& key : _simulationMap.keys())
-        if(key.DeviceId == deviceId)
-            map[{key.Type, key.Address}] = _simulationMap[key].Params;
+    for(auto&& table : _tables)
+    {
+        if(table.DeviceId != deviceId)
+            continue;
+
+        for(int row = 0; row < table.size(); row++)
+            map[{table.Type, table.Addresses[row]}] = table.Params[row];
+    }
 
     return map;
 }
@@ -134,39 +304,171 @@ ModbusSimulationMap DataSimulator::simulationMap(quint8 deviceId) const
 ///
 void DataSimulator::on_timeout()
 {
-    _elapsed++;
-    for(auto&& key : _simulationMap.keys())
+    // catch up on every tick since the last timeout, the timer itself may fire late
+    quint64 targetTick = _clockBase + _clock.elapsed() / TickInterval;
+    if(targetTick > _wheel.currentTick() + MaxCatchUpTicks)
     {
-        const auto mode = _simulationMap[key].Mode;
-        const auto params = _simulationMap[key].Params;
-        const auto interval = params.Interval;
+        // after a suspend or a long GUI stall the missed ticks are not replayed
+        targetTick = _wheel.currentTick() + MaxCatchUpTicks;
+        _clockBase = targetTick;
+        _clock.start();
+    }
 
-        if(_elapsed % interval) continue;
+    while(_wheel.currentTick() < targetTick)
+    {
+        _duePoints.resize(0);
+        _wheel.advance(_duePoints);
 
-        switch(params.Mode)
+        for(auto id : _duePoints)
         {
-            case SimulationMode::Random:
-                randomSimulation(mode, key.Type, key.Address, key.DeviceId, params.RandomParams);
-            break;
+            const auto it = _points.constFind(id);
+            if(it == _points.cend())
+                continue;
+
+            auto& table = _tables[it->Table];
+            const int row = it->Row;
+            if(table.DueTicks[row] != _wheel.currentTick())
+                continue;
+
+            const auto& params = table.Params[row];
+            if(params.isWaveform())
+                _waveforms.add(id, params.Mode, params.WaveformParams, _wheel.currentTick() * TickInterval);
+            else
+                simulate(table, row);
+
+            table.DueTicks[row] = _wheel.currentTick() + intervalTicks(params);
+            _wheel.schedule(id, table.DueTicks[row]);
+        }
 
-            case SimulationMode::Increment:
-                incrementSimulation(mode, key.Type, key.Address, key.DeviceId, params.IncrementParams);
-            break;
+        // waveforms are evaluated once per tick for all of the due points
+        _waveforms.generate();
+        _waveforms.forEach([this](int id, double value) {
+            const auto ref = _points.value(id);
+            realSimulation(_tables[ref.Table], ref.Row, value);
+        });
+        _waveforms.clear();
+    }
 
-            case SimulationMode::Decrement:
-                decrementSimailation(mode, key.Type, key.Address, key.DeviceId, params.DecrementParams);
-            break;
+    flushSimulatedValues();
+}
 
-            case SimulationMode::Toggle:
-                toggleSimulation(key.Type, key.Address, key.DeviceId);
-            break;
+///
+/// \brief DataSimulator::simulate
+/// \param table
+/// \param row
+///
+void DataSimulator::simulate(SimulationTable& table, int row)
+{
+    const auto& params = table.Params[row];
+    switch(params.Mode)
+    {
+        case SimulationMode::Random:
+            randomSimulation(table, row, params.RandomParams);
+        break;
 
-            default:
-            break;
-        }
+        case SimulationMode::Increment:
+            incrementSimulation(table, row, params.IncrementParams);
+        break;
+
+        case SimulationMode::Decrement:
+            decrementSimailation(table, row, params.DecrementParams);
+        break;
+
+        case SimulationMode::Toggle:
+            toggleSimulation(table, row);
+        break;
+
+        case SimulationMode::Expression:
+            expressionSimulation(table, row);
+        break;
+
+        default:
+        break;
     }
 }
 
+///
+/// \brief DataSimulator::addSimulatedValue
+/// \param table
+/// \param row
+///
+void DataSimulator::addSimulatedValue(const SimulationTable& table, int row)
+{
+    const auto mode = table.Modes[row];
+    const auto integer = table.Integers[row];
+
+    ModbusValue value;
+    switch(table.Type)
+    {
+        case QModbusDataUnit::Coils:
+        case QModbusDataUnit::DiscreteInputs:
+            value = integer != 0;
+        break;
+
+        default:
+            switch(mode)
+            {
+                case DataDisplayMode::Binary:
+                case DataDisplayMode::UInt16:
+                case DataDisplayMode::Hex:
+                    value = static_cast<quint16>(integer);
+                break;
+
+                case DataDisplayMode::Int16:
+                    value = static_cast<qint16>(integer);
+                break;
+
+                case DataDisplayMode::Int32:
+                case DataDisplayMode::SwappedInt32:
+                    value = static_cast<qint32>(integer);
+                break;
+
+                case DataDisplayMode::UInt32:
+                case DataDisplayMode::SwappedUInt32:
+                    value = static_cast<quint32>(integer);
+                break;
+
+                case DataDisplayMode::FloatingPt:
+                case DataDisplayMode::SwappedFP:
+                    value = static_cast<float>(table.Reals[row]);
+                break;
+
+                case DataDisplayMode::DblFloat:
+                case DataDisplayMode::SwappedDbl:
+                    value = table.Reals[row];
+                break;
+
+                case DataDisplayMode::Int64:
+                case DataDisplayMode::SwappedInt64:
+                    value = integer;
+                break;
+
+                case DataDisplayMode::UInt64:
+                case DataDisplayMode::SwappedUInt64:
+                    value = static_cast<quint64>(integer);
+                break;
+            }
+        break;
+    }
+
+    _simulatedValues.push_back({ mode, table.Type, table.Addresses[row], table.DeviceId, value });
+}
+
+///
+/// \brief DataSimulator::flushSimulatedValues
+///
+void DataSimulator::flushSimulatedValues()
+{
+    if(_simulatedValues.isEmpty())
+        return;
+
+    // values due in the same tick go out together so they can be written in as few requests as possible
+    SimulatedValues values;
+    values.swap(_simulatedValues);
+
+    emit dataSimulated(values);
+}
+
 template<typename T>
 T generateRandom(double from, double to)
 {
@@ -181,71 +483,70 @@ T generateRandom(const QRange<double>& range)
 
 ///
 /// \brief DataSimulator::randomSimulation
-/// \param mode
-/// \param type
-/// \param addr
-/// \param order
+/// \param table
+/// \param row
 /// \param params
 ///
-void DataSimulator::randomSimulation(DataDisplayMode mode, QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId, const RandomSimulationParams& params)
+void DataSimulator::randomSimulation(SimulationTable& table, int row, const RandomSimulationParams& params)
 {
-    auto&& value = _simulationMap[{ type, addr, deviceId}].CurrentValue;
-    switch(type)
+    auto& integer = table.Integers[row];
+    auto& real = table.Reals[row];
+
+    switch(table.Type)
     {
         case QModbusDataUnit::Coils:
         case QModbusDataUnit::DiscreteInputs:
-            value = generateRandom<quint16>(params.Range.from(), params.Range.to() + 1);
+            integer = generateRandom<quint16>(params.Range.from(), params.Range.to() + 1);
         break;
 
         case QModbusDataUnit::HoldingRegisters:
         case QModbusDataUnit::InputRegisters:
-            switch(mode)
+            switch(table.Modes[row])
             {
                 case DataDisplayMode::Binary:
                 case DataDisplayMode::Int16:
                 case DataDisplayMode::UInt16:
                 case DataDisplayMode::Hex:
-                    value = generateRandom<quint16>(params.Range.from(), params.Range.to() + 1);
+                    integer = generateRandom<quint16>(params.Range.from(), params.Range.to() + 1);
                 break;
 
                 case DataDisplayMode::Int32:
                 case DataDisplayMode::SwappedInt32:
-                    value = generateRandom<qint32>(params.Range);
+                    integer = generateRandom<qint32>(params.Range);
                 break;
 
                 case DataDisplayMode::UInt32:
                 case DataDisplayMode::SwappedUInt32:
-                    value = generateRandom<quint32>(params.Range);
+                    integer = generateRandom<quint32>(params.Range);
                 break;
 
                 case DataDisplayMode::FloatingPt:
                 case DataDisplayMode::SwappedFP:
-                   value = generateRandom<float>(params.Range);
+                   real = generateRandom<float>(params.Range);
                 break;
 
                 case DataDisplayMode::DblFloat:
                 case DataDisplayMode::SwappedDbl:
-                   value = generateRandom<double>(params.Range);
+                   real = generateRandom<double>(params.Range);
                 break;
 
                 case DataDisplayMode::Int64:
                 case DataDisplayMode::SwappedInt64:
-                    value = generateRandom<qint64>(params.Range);
+                    integer = generateRandom<qint64>(params.Range);
                 break;
 
                 case DataDisplayMode::UInt64:
                 case DataDisplayMode::SwappedUInt64:
-                    value = generateRandom<quint64>(params.Range);
+                    integer = static_cast<qint64>(generateRandom<quint64>(params.Range));
                 break;
             }
         break;
 
         default:
-        break;
+        return;
     }
 
-    if(value.isValid())
-        emit dataSimulated(mode, type, addr, deviceId, value);
+    addSimulatedValue(table, row);
 }
 
 template<typename T>
@@ -258,59 +559,59 @@ T incrementValue(T value, T step, const QRange<double>& range)
 
 ///
 /// \brief DataSimulator::incrementSimulation
-/// \param mode
-/// \param type
-/// \param addr
+/// \param table
+/// \param row
 /// \param params
 ///
-void DataSimulator::incrementSimulation(DataDisplayMode mode, QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId, const IncrementSimulationParams& params)
+void DataSimulator::incrementSimulation(SimulationTable& table, int row, const IncrementSimulationParams& params)
 {
-    auto&& value = _simulationMap[{ type, addr, deviceId}].CurrentValue;
-    switch(mode)
+    auto& integer = table.Integers[row];
+    auto& real = table.Reals[row];
+
+    switch(table.Modes[row])
     {
         case DataDisplayMode::Int16:
-            value = incrementValue<qint16>(value.toInt(), params.Step, params.Range);
+            integer = incrementValue<qint16>(integer, params.Step, params.Range);
         break;
 
         case DataDisplayMode::Binary:
         case DataDisplayMode::UInt16:
         case DataDisplayMode::Hex:
-            value = incrementValue<quint16>(value.toUInt(), params.Step, params.Range);
+            integer = incrementValue<quint16>(integer, params.Step, params.Range);
         break;
 
         case DataDisplayMode::Int32:
         case DataDisplayMode::SwappedInt32:
-            value = incrementValue<qint32>(value.toInt(),  params.Step, params.Range);
+            integer = incrementValue<qint32>(integer,  params.Step, params.Range);
         break;
 
         case DataDisplayMode::UInt32:
         case DataDisplayMode::SwappedUInt32:
-            value = incrementValue<quint32>(value.toUInt(),  params.Step, params.Range);
+            integer = incrementValue<quint32>(integer,  params.Step, params.Range);
         break;
 
         case DataDisplayMode::FloatingPt:
         case DataDisplayMode::SwappedFP:
-            value = incrementValue<float>(value.toFloat(), params.Step, params.Range);
+            real = incrementValue<float>(real, params.Step, params.Range);
         break;
 
         case DataDisplayMode::DblFloat:
         case DataDisplayMode::SwappedDbl:
-            value = incrementValue<double>(value.toDouble(), params.Step, params.Range);
+            real = incrementValue<double>(real, params.Step, params.Range);
         break;
 
         case DataDisplayMode::Int64:
         case DataDisplayMode::SwappedInt64:
-            value = incrementValue<qint64>(value.toLongLong(), params.Step, params.Range);
+            integer = incrementValue<qint64>(integer, params.Step, params.Range);
         break;
 
         case DataDisplayMode::UInt64:
         case DataDisplayMode::SwappedUInt64:
-            value = incrementValue<quint64>(value.toULongLong(), params.Step, params.Range);
+            integer = static_cast<qint64>(incrementValue<quint64>(integer, params.Step, params.Range));
         break;
     }
 
-    if(value.isValid())
-        emit dataSimulated(mode, type, addr, deviceId, value);
+    addSimulatedValue(table, row);
 }
 
 template<typename T>
@@ -323,71 +624,120 @@ T decrementValue(T value, T step, const QRange<double>& range)
 
 ///
 /// \brief DataSimulator::decrementSimailation
-/// \param mode
-/// \param type
-/// \param addr
-/// \param order
+/// \param table
+/// \param row
 /// \param params
 ///
-void DataSimulator::decrementSimailation(DataDisplayMode mode, QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId, const DecrementSimulationParams& params)
+void DataSimulator::decrementSimailation(SimulationTable& table, int row, const DecrementSimulationParams& params)
 {
-    auto&& value = _simulationMap[{ type, addr, deviceId}].CurrentValue;
-    switch(mode)
+    auto& integer = table.Integers[row];
+    auto& real = table.Reals[row];
+
+    switch(table.Modes[row])
     {
         case DataDisplayMode::Int16:
-            value = decrementValue<qint16>(value.toInt(), params.Step, params.Range);
+            integer = decrementValue<qint16>(integer, params.Step, params.Range);
         break;
 
         case DataDisplayMode::Binary:
         case DataDisplayMode::UInt16:
         case DataDisplayMode::Hex:
-            value = decrementValue<quint16>(value.toUInt(), params.Step, params.Range);
+            integer = decrementValue<quint16>(integer, params.Step, params.Range);
         break;
 
         case DataDisplayMode::Int32:
         case DataDisplayMode::SwappedInt32:
-            value = decrementValue<qint32>(value.toInt(),  params.Step, params.Range);
+            integer = decrementValue<qint32>(integer,  params.Step, params.Range);
             break;
 
         case DataDisplayMode::UInt32:
         case DataDisplayMode::SwappedUInt32:
-            value = decrementValue<quint32>(value.toUInt(),  params.Step, params.Range);
+            integer = decrementValue<quint32>(integer,  params.Step, params.Range);
         break;
 
         case DataDisplayMode::FloatingPt:
         case DataDisplayMode::SwappedFP:
-            value = decrementValue<float>(value.toFloat(), params.Step, params.Range);
+            real = decrementValue<float>(real, params.Step, params.Range);
         break;
 
         case DataDisplayMode::DblFloat:
         case DataDisplayMode::SwappedDbl:
-            value = decrementValue<double>(value.toDouble(), params.Step, params.Range);
+            real = decrementValue<double>(real, params.Step, params.Range);
         break;
 
         case DataDisplayMode::Int64:
         case DataDisplayMode::SwappedInt64:
-            value = decrementValue<qint64>(value.toLongLong(), params.Step, params.Range);
+            integer = decrementValue<qint64>(integer, params.Step, params.Range);
         break;
 
         case DataDisplayMode::UInt64:
         case DataDisplayMode::SwappedUInt64:
-            value = decrementValue<quint64>(value.toULongLong(), params.Step, params.Range);
+            integer = static_cast<qint64>(decrementValue<quint64>(integer, params.Step, params.Range));
         break;
     }
 
-    if(value.isValid())
-        emit dataSimulated(mode, type, addr, deviceId, value);
+    addSimulatedValue(table, row);
 }
 
 ///
 /// \brief DataSimulator::toggleSimulation
-/// \param type
-/// \param addr
+/// \param table
+/// \param row
+///
+void DataSimulator::toggleSimulation(SimulationTable& table, int row)
+{
+    table.Integers[row] = !table.Integers[row];
+
+    addSimulatedValue(table, row);
+}
+
+///
+/// \brief DataSimulator::realSimulation
+/// \param table
+/// \param row
+/// \param value
+///
+void DataSimulator::realSimulation(SimulationTable& table, int row, double value)
+{
+    table.Reals[row] = value;
+    table.Integers[row] = qRound64(value);
+
+    addSimulatedValue(table, row);
+}
+
+///
+/// \brief DataSimulator::expressionSimulation
+/// \param table
+/// \param row
 ///
-void DataSimulator::toggleSimulation(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId)
+void DataSimulator::expressionSimulation(SimulationTable& table, int row)
 {
-    auto&& value = _simulationMap[{ type, addr, deviceId}].CurrentValue;
-    value = !value.toBool();
+    const auto& expression = table.Expressions[row];
+    if(!expression.isValid())
+        return;
 
-    emit dataSimulated(DataDisplayMode::Binary, type, addr, deviceId, value);
+    SimulationExpression::Context ctx;
+    ctx.Time = _wheel.currentTick() * TickInterval / 1000.;
+    for(auto type : { QModbusDataUnit::DiscreteInputs, QModbusDataUnit::Coils, QModbusDataUnit::InputRegisters, QModbusDataUnit::HoldingRegisters })
+    {
+        const auto it = _registers.constFind(tableKey(type, table.DeviceId));
+        ctx.Registers[type] = it != _registers.cend() ? &it.value() : nullptr;
+    }
+
+    const double value = expression.evaluate(ctx);
+    if(!std::isfinite(value))
+        return;
+
+    switch(table.Type)
+    {
+        case QModbusDataUnit::Coils:
+        case QModbusDataUnit::DiscreteInputs:
+            table.Integers[row] = value != 0.;
+            addSimulatedValue(table, row);
+        break;
+
+        default:
+            realSimulation(table, row, value);
+        break;
+    }
 }
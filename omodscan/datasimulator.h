@@ -1,12 +1,31 @@
 #ifndef DATASIMULATOR_H
 #define DATASIMULATOR_H
 
+#include <QHash>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QModbusDataUnit>
+#include "timerwheel.h"
+#include "waveformgenerator.h"
+#include "simulationexpression.h"
+#include "modbusvalue.h"
 #include "modbussimulationparams.h"
 
 typedef QMap<QPair<QModbusDataUnit::RegisterType, quint16>, ModbusSimulationParams> ModbusSimulationMap;
 
+///
+/// \brief The SimulatedValue struct
+///
+struct SimulatedValue
+{
+    DataDisplayMode Mode;
+    QModbusDataUnit::RegisterType Type;
+    quint16 Address;
+    quint8 DeviceId;
+    ModbusValue Value;
+};
+typedef QVector<SimulatedValue> SimulatedValues;
+
 ///
 /// \brief The DataSimulator class
 ///
@@ -15,6 +34,8 @@ class DataSimulator : public QObject
     Q_OBJECT
 
 public:
+    static const int TickInterval = 10;
+
     explicit DataSimulator(QObject* parent);
     ~DataSimulator() override;
 
@@ -22,6 +43,8 @@ public:
     void stopSimulation(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId);
     void stopSimulations();
 
+    void updateRegisters(quint8 deviceId, const QModbusDataUnit& data);
+
     void pauseSimulations();
     void resumeSimulations();
     void restartSimulations();
@@ -32,27 +55,40 @@ public:
 signals:
     void simulationStarted(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId);
     void simulationStopped(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId);
-    void dataSimulated(DataDisplayMode mode, QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId, QVariant value);
+    void dataSimulated(const SimulatedValues& values);
 
 private slots:
     void on_timeout();
 
 private:
-    void randomSimulation(DataDisplayMode mode, QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId, const RandomSimulationParams& params);
-    void incrementSimulation(DataDisplayMode mode, QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId, const IncrementSimulationParams& params);
-    void decrementSimailation(DataDisplayMode mode, QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId, const DecrementSimulationParams& params);
-    void toggleSimulation(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId);
+    ///
+    /// \brief The SimulationTable struct holds the points of one device and register type column by column
+    ///
+    struct SimulationTable
+    {
+        QModbusDataUnit::RegisterType Type = QModbusDataUnit::Invalid;
+        quint8 DeviceId = 0;
 
-private:
-    QTimer _timer;
-    quint32 _elapsed;
-    const int _interval = 1000;
+        QVector<int> Ids;
+        QVector<quint16> Addresses;
+        QVector<DataDisplayMode> Modes;
+        QVector<ModbusSimulationParams> Params;
+        QVector<quint64> DueTicks;
+        QVector<qint64> Integers;
+        QVector<double> Reals;
+        QVector<SimulationExpression> Expressions;
+
+        int size() const { return Ids.size(); }
+        int append(int id, quint16 addr, DataDisplayMode mode, const ModbusSimulationParams& params);
+        int removeAt(int row);
+    };
 
-    struct SimulationParams {
-        DataDisplayMode Mode;
-        ModbusSimulationParams Params;
-        QVariant CurrentValue;
+    struct PointRef
+    {
+        quint32 Table;
+        int Row;
     };
+
     struct SimulationKey{
         QModbusDataUnit::RegisterType Type;
         quint16 Address;
@@ -63,7 +99,37 @@ private:
         }
     };
 
-    QMap<SimulationKey, SimulationParams> _simulationMap;
+    static quint32 tableKey(QModbusDataUnit::RegisterType type, quint8 deviceId);
+    static quint64 intervalTicks(const ModbusSimulationParams& params);
+
+    void removeSimulation(const SimulationKey& key);
+    void simulate(SimulationTable& table, int row);
+
+    void randomSimulation(SimulationTable& table, int row, const RandomSimulationParams& params);
+    void incrementSimulation(SimulationTable& table, int row, const IncrementSimulationParams& params);
+    void decrementSimailation(SimulationTable& table, int row, const DecrementSimulationParams& params);
+    void toggleSimulation(SimulationTable& table, int row);
+    void realSimulation(SimulationTable& table, int row, double value);
+    void expressionSimulation(SimulationTable& table, int row);
+
+    void addSimulatedValue(const SimulationTable& table, int row);
+    void flushSimulatedValues();
+
+private:
+    QTimer _timer;
+    QElapsedTimer _clock;
+    quint64 _clockBase;
+    TimerWheel _wheel;
+    QVector<int> _duePoints;
+    WaveformGenerator _waveforms;
+
+    int _nextPointId;
+    QHash<quint32, SimulationTable> _tables;
+    QHash<int, PointRef> _points;
+    QMap<SimulationKey, int> _pointIds;
+    QHash<quint32, QVector<quint16>> _registers;
+
+    SimulatedValues _simulatedValues;
 };
 
 #endif // DATASIMULATOR_H
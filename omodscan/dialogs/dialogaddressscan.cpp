@@ -93,16 +93,22 @@ bool TableViewItemModel::setData(const QModelIndex &index, const QVariant &value
     const auto idx = index.row() * _columns + index.column();
     if(value.userType() == qMetaTypeId<QVector<quint16>>())
     {
-        const auto values = value.value<QVector<quint16>>();
-        for(int i = 0; i < values.size(); i++)
-            _data.setValue(idx + i, values.at(i));
-
-        emit dataChanged(index, this->index(rowCount() - 1, columnCount() - 1), QVector<int>() << Qt::DisplayRole);
+        const auto count = _data.setValues(idx, value.value<QVector<quint16>>());
+        if(count <= 0)
+            return false;
+
+        // notify only the rows the values landed in
+        const auto last = idx + count - 1;
+        const auto lastRow = last / _columns;
+        if(lastRow == index.row())
+            emit dataChanged(index, this->index(lastRow, last % _columns), QVector<int>() << Qt::DisplayRole << Qt::BackgroundRole);
+        else
+            emit dataChanged(this->index(index.row(), 0), this->index(lastRow, _columns - 1), QVector<int>() << Qt::DisplayRole << Qt::BackgroundRole);
     }
     else
     {
         _data.setValue(idx, value.toUInt());
-        emit dataChanged(index, index, QVector<int>() << Qt::DisplayRole);
+        emit dataChanged(index, index, QVector<int>() << Qt::DisplayRole << Qt::BackgroundRole);
     }
 
     return true;
@@ -179,6 +185,40 @@ void TableViewItemModel::setAddressBase(AddressBase base)
     _addressBase = base;
 }
 
+///
+/// \brief TableViewItemModel::reset
+/// \param data
+/// \param columns
+///
+void TableViewItemModel::reset(const ModbusRegisterStore& data, int columns)
+{
+    const auto rows = qCeil(data.valueCount() / (double)columns);
+    if(columns != _columns || rows != rowCount())
+    {
+        beginResetModel();
+        _columns = columns;
+        _data = data;
+        endResetModel();
+        return;
+    }
+
+    // the table keeps its shape, so repaint the cells and row headers instead of resetting the view
+    _data = data;
+    updateAll();
+
+    if(rows > 0)
+        emit headerDataChanged(Qt::Vertical, 0, rows - 1);
+}
+
+///
+/// \brief TableViewItemModel::updateAll
+///
+void TableViewItemModel::updateAll()
+{
+    if(rowCount() > 0)
+        emit dataChanged(index(0, 0), index(rowCount() - 1, _columns - 1), QVector<int>() << Qt::DisplayRole << Qt::BackgroundRole);
+}
+
 ///
 /// \brief TableViewItemModel::getAddress
 /// \param idx
@@ -195,6 +235,7 @@ int TableViewItemModel::getAddress(int idx) const
 ///
 LogViewModel::LogViewModel(QObject* parent)
     : QAbstractListModel(parent)
+    ,_cache(CacheSize)
 {
 }
 
@@ -203,7 +244,7 @@ LogViewModel::LogViewModel(QObject* parent)
 ///
 LogViewModel::~LogViewModel()
 {
-    void deleteItems();
+    deleteItems();
 }
 
 ///
@@ -213,7 +254,7 @@ LogViewModel::~LogViewModel()
 ///
 int LogViewModel::rowCount(const QModelIndex&) const
 {
-    return _items.size();
+    return _count;
 }
 
 ///
@@ -226,33 +267,84 @@ QVariant LogViewModel::data(const QModelIndex& index, int role) const
 {
     if(!index.isValid() ||
        index.row() < 0  ||
-       index.row() >= _items.size())
+       index.row() >= _count)
     {
         return QVariant();
     }
 
-    const auto item = _items.at(index.row());
+    const auto item = this->item(index.row());
+    if(item == nullptr)
+        return QVariant();
+
     switch(role)
     {
         case Qt::DisplayRole:
         {
             const DataDisplayMode mode = _hexView ? DataDisplayMode::Hex : DataDisplayMode::UInt16;
-            const auto addr = item.Addr + (_addressBase == AddressBase::Base1 ? 1 : 0);
-            return QString("[%1] %2 [%3]").arg(formatAddress(item.Type, addr, false),
-                                               item.Msg->isRequest() ? "<<" : ">>",
-                                               item.Msg->toString(mode));
+            const auto addr = item->Addr + (_addressBase == AddressBase::Base1 ? 1 : 0);
+            return QString("[%1] %2 [%3]").arg(formatAddress(item->Type, addr, false),
+                                               item->Msg->isRequest() ? "<<" : ">>",
+                                               item->Msg->toString(mode));
         }
 
         case Qt::BackgroundRole:
-            return item.Msg->isRequest() ? QVariant() : QColor(0xDCDCDC);
+            return item->Msg->isRequest() ? QVariant() : QColor(0xDCDCDC);
 
         case Qt::UserRole:
-            return QVariant::fromValue(item.Msg);
+            return QVariant::fromValue(item->Msg);
     }
 
     return QVariant();
 }
 
+///
+/// \brief LogViewModel::append
+/// \param addr
+/// \param type
+/// \param msg
+///
+void LogViewModel::append(quint16 addr, QModbusDataUnit::RegisterType type, const ModbusMessage* msg)
+{
+    if(msg == nullptr) return;
+
+    if(_count % 64 == 0)
+        _validBits.push_back(0);
+
+    if(msg->isValid() && !msg->isRequest() && !msg->isException())
+        _validBits[_count / 64] |= (quint64(1) << (_count % 64));
+
+    beginInsertRows(QModelIndex(), _count, _count);
+    _items.enqueue({ addr, type, msg });
+    _count++;
+    endInsertRows();
+
+    if(_items.size() >= MaxItems + SpillBatch)
+        spillItems();
+}
+
+///
+/// \brief LogViewModel::clear
+///
+void LogViewModel::clear()
+{
+    beginResetModel();
+    deleteItems();
+    endResetModel();
+}
+
+///
+/// \brief LogViewModel::isValidResponse
+/// \param row
+/// \return
+///
+bool LogViewModel::isValidResponse(int row) const
+{
+    if(row < 0 || row >= _count)
+        return false;
+
+    return _validBits.at(row / 64) & (quint64(1) << (row % 64));
+}
+
 ///
 /// \brief LogViewModel::addressBse
 /// \return
@@ -280,6 +372,80 @@ void LogViewModel::deleteItems()
             delete i.Msg;
 
     _items.clear();
+    _offsets.clear();
+    _validBits.clear();
+    _cache.clear();
+    _count = 0;
+
+    if(_file.isOpen())
+        _file.resize(0);
+}
+
+///
+/// \brief LogViewModel::spillItems
+///
+void LogViewModel::spillItems()
+{
+    if(!_file.isOpen() && !_file.open())
+        return; // no temporary storage, keep everything in memory
+
+    _file.seek(_file.size());
+    QDataStream out(&_file);
+
+    // move the oldest entries out of memory, keeping only their file offsets
+    for(int i = 0; i < SpillBatch && !_items.isEmpty(); i++)
+    {
+        const auto item = _items.dequeue();
+        _offsets.push_back(_file.pos());
+
+        out << item.Addr;
+        out << (int)item.Type;
+        out << item.Msg->isRequest();
+        out << (int)item.Msg->protocolType();
+        out << item.Msg->timestamp().toMSecsSinceEpoch();
+        out << item.Msg->rawData();
+
+        delete item.Msg;
+    }
+}
+
+///
+/// \brief LogViewModel::item
+/// \param row
+/// \return
+///
+const LogViewModel::LogViewItem* LogViewModel::item(int row) const
+{
+    const auto spilled = _offsets.size();
+    if(row >= spilled)
+        return &_items.at(row - spilled);
+
+    if(auto cached = _cache.object(row))
+        return cached;
+
+    auto& file = const_cast<QTemporaryFile&>(_file);
+    if(!file.seek(_offsets.at(row)))
+        return nullptr;
+
+    QDataStream in(&file);
+
+    quint16 addr;
+    int type, protocol;
+    bool request;
+    qint64 timestamp;
+    QByteArray data;
+    in >> addr >> type >> request >> protocol >> timestamp >> data;
+
+    if(in.status() != QDataStream::Ok)
+        return nullptr;
+
+    auto cached = new LogViewCachedItem;
+    cached->Addr = addr;
+    cached->Type = (QModbusDataUnit::RegisterType)type;
+    cached->Msg = ModbusMessage::create(data, (ModbusMessage::ProtocolType)protocol, QDateTime::fromMSecsSinceEpoch(timestamp), request);
+
+    _cache.insert(row, cached);
+    return cached;
 }
 
 ///
@@ -300,9 +466,99 @@ LogViewProxyModel::LogViewProxyModel(QObject* parent)
 ///
 bool LogViewProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
-    const auto index = sourceModel()->index(source_row, 0, source_parent);
-    const auto msg = sourceModel()->data(index, Qt::UserRole).value<const ModbusMessage*>();
-    return _showValid ? msg->isValid() && !msg->isRequest() && !msg->isException() : true;
+    Q_UNUSED(source_parent)
+    return _showValid ? ((LogViewModel*)sourceModel())->isValidResponse(source_row) : true;
+}
+
+///
+/// \brief AddressRangeMap::setDeviceId
+/// \param deviceId
+///
+void AddressRangeMap::setDeviceId(int deviceId)
+{
+    if(_deviceId != deviceId)
+        _ranges.clear();
+
+    _deviceId = deviceId;
+}
+
+///
+/// \brief AddressRangeMap::isEmpty
+/// \return
+///
+bool AddressRangeMap::isEmpty() const
+{
+    for(auto&& ranges : _ranges)
+    {
+        if(!ranges.isEmpty())
+            return false;
+    }
+
+    return true;
+}
+
+///
+/// \brief AddressRangeMap::clear
+/// \param pointType
+///
+void AddressRangeMap::clear(QModbusDataUnit::RegisterType pointType)
+{
+    _ranges.remove(pointType);
+}
+
+///
+/// \brief AddressRangeMap::add
+/// \param pointType
+/// \param address
+/// \param count
+///
+void AddressRangeMap::add(QModbusDataUnit::RegisterType pointType, int address, int count)
+{
+    if(count <= 0)
+        return;
+
+    // ranges are stored as start -> end and merged with adjacent or overlapping ones
+    auto& ranges = _ranges[pointType];
+    int from = address;
+    int to = address + count - 1;
+
+    auto it = ranges.upperBound(from);
+    if(it != ranges.begin() && std::prev(it).value() >= from - 1)
+        --it;
+
+    while(it != ranges.end() && it.key() <= to + 1)
+    {
+        from = qMin(from, it.key());
+        to = qMax(to, it.value());
+        it = ranges.erase(it);
+    }
+
+    ranges.insert(from, to);
+}
+
+///
+/// \brief AddressRangeMap::pointTypes
+/// \return
+///
+QList<QModbusDataUnit::RegisterType> AddressRangeMap::pointTypes() const
+{
+    return _ranges.keys();
+}
+
+///
+/// \brief AddressRangeMap::ranges
+/// \param pointType
+/// \return
+///
+QVector<QRange<int>> AddressRangeMap::ranges(QModbusDataUnit::RegisterType pointType) const
+{
+    QVector<QRange<int>> result;
+
+    const auto ranges = _ranges.value(pointType);
+    for(auto it = ranges.cbegin(); it != ranges.cend(); ++it)
+        result.push_back(QRange<int>(it.key(), it.value()));
+
+    return result;
 }
 
 ///
@@ -339,20 +595,21 @@ DialogAddressScan::DialogAddressScan(const DisplayDefinition& dd, DataDisplayMod
     ui->lineEditStartAddress->setValue(dd.PointAddress);
     ui->lineEditSlaveAddress->setValue(dd.DeviceId);
     ui->lineEditLength->setValue(999);
+    ui->spinBoxOutstanding->setMaximum(ModbusClient::MaxTcpRequests);
+    ui->spinBoxOutstanding->setValue(ModbusClient::MaxTcpRequests / 2);
     ui->tabWidget->setCurrentIndex(0);
     ui->checkBoxHexView->setChecked(mode == DataDisplayMode::Hex);
     ui->comboBoxByteOrder->setCurrentByteOrder(order);
     ui->info->setShowTimestamp(false);
 
-    auto dispatcher = QAbstractEventDispatcher::instance();
-    connect(dispatcher, &QAbstractEventDispatcher::awake, this, &DialogAddressScan::on_awake);
-
     connect(&_scanTimer, &QTimer::timeout, this, &DialogAddressScan::on_timeout);
     connect(&_modbusClient, &ModbusClient::modbusReply, this, &DialogAddressScan::on_modbusReply);
     connect(&_modbusClient, &ModbusClient::modbusRequest, this, &DialogAddressScan::on_modbusRequest);
+    connect(&_modbusClient, &ModbusClient::modbusError, this, &DialogAddressScan::on_modbusError);
     connect(proxyLogModel->sourceModel(), &LogViewModel::rowsInserted, ui->logView, &QListView::scrollToBottom);
 
     clearTableView();
+    updateControls();
 }
 
 ///
@@ -360,6 +617,13 @@ DialogAddressScan::DialogAddressScan(const DisplayDefinition& dd, DataDisplayMod
 ///
 DialogAddressScan::~DialogAddressScan()
 {
+    if(_exportThread)
+    {
+        _exportThread->requestInterruption();
+        _exportThread->quit();
+        _exportThread->wait();
+    }
+
     delete ui;
 }
 
@@ -376,17 +640,20 @@ void DialogAddressScan::changeEvent(QEvent* event)
 }
 
 ///
-/// \brief DialogAddressScan::on_awake
+/// \brief DialogAddressScan::updateControls
 ///
-void DialogAddressScan::on_awake()
+void DialogAddressScan::updateControls()
 {
     ui->lineEditStartAddress->setEnabled(!_scanning);
     ui->lineEditLength->setEnabled(!_scanning);
     ui->lineEditSlaveAddress->setEnabled(!_scanning);
-    ui->spinBoxRegsOnQuery->setEnabled(!_scanning);
+    ui->spinBoxRegsOnQuery->setEnabled(!_scanning && !ui->checkBoxDiscovery->isChecked());
+    ui->checkBoxDiscovery->setEnabled(!_scanning);
+    ui->spinBoxOutstanding->setEnabled(!_scanning && _modbusClient.connectionType() == ConnectionType::Tcp);
     ui->comboBoxPointType->setEnabled(!_scanning);
-    ui->pushButtonExport->setEnabled(_finished);
-    ui->progressBar->setVisible(_scanning);
+    ui->pushButtonExport->setEnabled(_finished && !_exporting);
+    ui->pushButtonScan->setEnabled(!_exporting);
+    ui->progressBar->setVisible(_scanning || _exporting);
     ui->pushButtonScan->setText(_scanning ? tr("Stop") : tr("Scan"));
 }
 
@@ -397,6 +664,8 @@ void DialogAddressScan::on_timeout()
 {
     const auto elapsed = QDateTime::fromSecsSinceEpoch(_scanTime++).toUTC().toString("hh:mm:ss");
     ui->labelElapsed->setText(elapsed);
+
+    updateThroughput();
 }
 
 ///
@@ -419,6 +688,16 @@ void DialogAddressScan::on_checkBoxShowValid_toggled(bool on)
     ((LogViewProxyModel*)ui->logView->model())->setShowValid(on);
 }
 
+///
+/// \brief DialogAddressScan::on_checkBoxDiscovery_toggled
+/// \param on
+///
+void DialogAddressScan::on_checkBoxDiscovery_toggled(bool on)
+{
+    Q_UNUSED(on)
+    updateControls();
+}
+
 ///
 /// \brief DialogAddressScan::on_lineEditStartAddress_valueChanged
 /// \param value
@@ -495,9 +774,11 @@ void DialogAddressScan::on_logView_clicked(const QModelIndex &index)
         return;
     }
 
+    // the log may spill or evict the message later, so show a copy of it
     auto proxyLogModel = ((LogViewProxyModel*)ui->logView->model());
     auto msg = proxyLogModel->data(index, Qt::UserRole).value<const ModbusMessage*>();
-    ui->info->setModbusMessage(msg);
+    _selectedMessage.reset(msg ? ModbusMessage::create(msg->rawData(), msg->protocolType(), msg->timestamp(), msg->isRequest()) : nullptr);
+    ui->info->setModbusMessage(_selectedMessage.data());
 }
 
 ///
@@ -509,8 +790,22 @@ void DialogAddressScan::on_logView_clicked(const QModelIndex &index)
 ///
 void DialogAddressScan::on_modbusRequest(int requestId, int deviceId, int transactionId, const QModbusRequest& request)
 {
-    if(requestId == -1)
-        updateLogView(deviceId, transactionId, request);
+    if(requestId != -1)
+        return;
+
+    updateLogView(deviceId, transactionId, request);
+
+    quint16 pointAddress;
+    request.decodeData(&pointAddress);
+
+    for(int i = 0; i < _queuedBlocks.size(); i++)
+    {
+        if(_queuedBlocks.at(i).first == pointAddress)
+        {
+            _sentBlocks[pointAddress] = _queuedBlocks.takeAt(i).second;
+            break;
+        }
+    }
 }
 
 ///
@@ -526,21 +821,50 @@ void DialogAddressScan::on_modbusReply(QModbusReply* reply)
         return;
     }
 
-    updateProgress();
+    // replies left over from a previous scan are not ours
+    const auto address = reply->property("RequestData").value<QModbusDataUnit>().startAddress();
+    if(!_sentBlocks.contains(address))
+        return;
+
+    const auto count = _sentBlocks.take(address);
+
     updateLogView(reply);
 
     if (reply->error() == QModbusDevice::NoError)
-        updateTableView(reply->result().startAddress(), reply->result().values());
-
-    if(_requestCount > ui->lineEditLength->value<int>()
-                       + ui->spinBoxRegsOnQuery->value())
-    {
-        stopScan();
-    }
-    else
     {
-        sendReadRequest();
+        updateTableView(reply->result().startAddress(), reply->result().values());
+        if(ui->checkBoxDiscovery->isChecked())
+            _rangeMap.add(ui->comboBoxPointType->currentPointType(), address, count);
     }
+
+    _completedCount++;
+    if(!splitBlock(reply, address, count))
+        _resolvedCount += count;
+
+    requestFinished();
+}
+
+///
+/// \brief DialogAddressScan::on_modbusError
+/// \param error
+/// \param requestId
+///
+void DialogAddressScan::on_modbusError(const QString& error, int requestId)
+{
+    Q_UNUSED(error)
+
+    if(!_scanning || requestId != -1 || _queuedBlocks.isEmpty())
+        return;
+
+    // the request was dropped without sending, so no reply will come for it;
+    // scan requests leave the client queue in order, so it is the oldest queued block
+    _completedCount++;
+    _resolvedCount += _queuedBlocks.takeFirst().second;
+
+    // defer refilling the pipeline to avoid recursing into fillPipeline
+    QTimer::singleShot(0, this, [this]{
+        if(_scanning) requestFinished();
+    });
 }
 
 ///
@@ -559,11 +883,17 @@ void DialogAddressScan::on_pushButtonScan_clicked()
 ///
 void DialogAddressScan::on_pushButtonExport_clicked()
 {
-    auto filename = QFileDialog::getSaveFileName(this, QString(), windowTitle(), tr("Pdf files (*.pdf);;CSV files (*.csv)"));
+    auto filters = tr("Pdf files (*.pdf);;CSV files (*.csv);;Binary files (*.bin)");
+    if(!_rangeMap.isEmpty())
+        filters += tr(";;Address map files (*.txt)");
+
+    auto filename = QFileDialog::getSaveFileName(this, QString(), windowTitle(), filters);
     if(filename.isEmpty()) return;
 
     if(!filename.endsWith(".pdf", Qt::CaseInsensitive) &&
-       !filename.endsWith(".csv", Qt::CaseInsensitive))
+       !filename.endsWith(".csv", Qt::CaseInsensitive) &&
+       !filename.endsWith(".bin", Qt::CaseInsensitive) &&
+       !filename.endsWith(".txt", Qt::CaseInsensitive))
     {
         filename += ".pdf";
     }
@@ -571,7 +901,11 @@ void DialogAddressScan::on_pushButtonExport_clicked()
     if(filename.endsWith(".pdf", Qt::CaseInsensitive))
         exportPdf(filename);
     else if(filename.endsWith(".csv", Qt::CaseInsensitive))
-        exportCsv(filename);
+        exportStore(filename, StoreExporter::Csv);
+    else if(filename.endsWith(".bin", Qt::CaseInsensitive))
+        exportStore(filename, StoreExporter::Binary);
+    else if(filename.endsWith(".txt", Qt::CaseInsensitive))
+        exportMap(filename);
 }
 
 ///
@@ -590,14 +924,22 @@ void DialogAddressScan::startScan()
 
     _scanning = true;
     _finished = false;
+    updateControls();
 
     clearTableView();
     clearLogView();
     clearScanTime();
     clearProgress();
 
-    sendReadRequest();
+    if(ui->checkBoxDiscovery->isChecked())
+    {
+        _rangeMap.setDeviceId(ui->lineEditSlaveAddress->value<int>());
+        _rangeMap.clear(ui->comboBoxPointType->currentPointType());
+    }
+
+    _throughputTimer.start();
     _scanTimer.start(1000);
+    fillPipeline();
 }
 
 ///
@@ -611,31 +953,152 @@ void DialogAddressScan::stopScan()
     _scanning = false;
     _finished = true;
     _scanTimer.stop();
+    _queuedBlocks.clear();
+    _sentBlocks.clear();
+    _splitBlocks.clear();
+    updateThroughput();
+    updateControls();
 }
 
 ///
 /// \brief DialogAddressScan::sendReadRequest
+/// \return
 ///
-void DialogAddressScan::sendReadRequest()
+bool DialogAddressScan::sendReadRequest()
 {
     const auto deviceId = ui->lineEditSlaveAddress->value<int>();
     const auto pointType = ui->comboBoxPointType->currentPointType();
     const auto pointAddress = ui->lineEditStartAddress->value<int>();
-    const auto count = ui->spinBoxRegsOnQuery->value();
+    const auto length = ui->lineEditLength->value<int>();
     const auto addressBase = ui->comboBoxAddressBase->currentAddressBase();
-    const auto address = (addressBase == AddressBase::Base0 ? pointAddress : pointAddress - 1) + _requestCount;
+    const auto lastAddress = ModbusLimits::addressRange().to();
 
-    if(address > ModbusLimits::addressRange().to())
+    int address, count;
+    if(!_splitBlocks.isEmpty())
     {
-        stopScan();
+        // halves of failed blocks go first, so each range boundary converges quickly
+        const auto block = _splitBlocks.dequeue();
+        address = block.first;
+        count = block.second;
     }
     else
     {
+        address = (addressBase == AddressBase::Base0 ? pointAddress : pointAddress - 1) + _requestCount;
+        if(_requestCount >= length || address > lastAddress)
+            return false;
+
+        count = qMin(qMin(blockSize(), length - _requestCount), lastAddress - address + 1);
         _requestCount += count;
-        _modbusClient.sendReadRequest(pointType, address, count, deviceId, -1);
+    }
+
+    // the block has to be queued first, the request may go out right away
+    _queuedBlocks.push_back({ address, count });
+    if(!_modbusClient.sendReadRequest(pointType, address, count, deviceId, -1))
+    {
+        _queuedBlocks.removeLast();
+        return false;
+    }
+
+    return true;
+}
+
+///
+/// \brief DialogAddressScan::fillPipeline
+///
+void DialogAddressScan::fillPipeline()
+{
+    while(_scanning && outstanding() < maxOutstanding())
+    {
+        if(!sendReadRequest())
+            break;
+    }
+
+    if(_scanning && outstanding() == 0)
+        stopScan();
+}
+
+///
+/// \brief DialogAddressScan::requestFinished
+///
+void DialogAddressScan::requestFinished()
+{
+    updateProgress();
+    fillPipeline();
+}
+
+///
+/// \brief DialogAddressScan::outstanding
+/// \return
+///
+int DialogAddressScan::outstanding() const
+{
+    return _queuedBlocks.size() + _sentBlocks.size();
+}
+
+///
+/// \brief DialogAddressScan::blockSize
+/// \return
+///
+int DialogAddressScan::blockSize() const
+{
+    if(!ui->checkBoxDiscovery->isChecked())
+        return ui->spinBoxRegsOnQuery->value();
+
+    // discovery starts from the largest blocks the protocol allows
+    switch(ui->comboBoxPointType->currentPointType())
+    {
+        case QModbusDataUnit::Coils:
+        case QModbusDataUnit::DiscreteInputs:
+            return ModbusLimits::bitsLengthRange().to();
+
+        default:
+            return ModbusLimits::lengthRange().to();
     }
 }
 
+///
+/// \brief DialogAddressScan::splitBlock
+/// \param reply
+/// \param address
+/// \param count
+/// \return
+///
+bool DialogAddressScan::splitBlock(const QModbusReply* reply, int address, int count)
+{
+    if(!ui->checkBoxDiscovery->isChecked() || count < 2)
+        return false;
+
+    if(reply->error() != QModbusDevice::ProtocolError)
+        return false;
+
+    switch(reply->rawResult().exceptionCode())
+    {
+        case QModbusPdu::IllegalDataAddress:
+        case QModbusPdu::IllegalDataValue:
+        {
+            const auto half = count / 2;
+            _splitBlocks.enqueue({ address, half });
+            _splitBlocks.enqueue({ address + half, count - half });
+        }
+        return true;
+
+        default:
+        return false;
+    }
+}
+
+///
+/// \brief DialogAddressScan::maxOutstanding
+/// \return
+///
+int DialogAddressScan::maxOutstanding() const
+{
+    if(_modbusClient.connectionType() != ConnectionType::Tcp)
+        return 1;
+
+    return qMin(ui->spinBoxOutstanding->value(), _modbusClient.maxInFlight());
+}
+
 ///
 /// \brief DialogAddressScan::clearTableView
 ///
@@ -646,7 +1109,7 @@ void DialogAddressScan::clearTableView()
     const auto pointAddress = ui->lineEditStartAddress->value<int>();
     const auto addressBase = ui->comboBoxAddressBase->currentAddressBase();
 
-    ModbusDataUnit data(pointType, addressBase == AddressBase::Base0 ? pointAddress : pointAddress - 1, length);
+    ModbusRegisterStore data(pointType, addressBase == AddressBase::Base0 ? pointAddress : pointAddress - 1, length);
     ((TableViewItemModel*)ui->tableView->model())->reset(data);
 
     ui->tableView->resizeColumnsToContents();
@@ -661,6 +1124,7 @@ void DialogAddressScan::clearTableView()
 void DialogAddressScan::clearLogView()
 {
     ui->info->clear();
+    _selectedMessage.reset();
     ((LogViewProxyModel*)ui->logView->model())->clear();
 }
 
@@ -679,7 +1143,10 @@ void DialogAddressScan::clearScanTime()
 void DialogAddressScan::clearProgress()
 {
     _requestCount = 0;
+    _completedCount = 0;
+    _resolvedCount = 0;
     ui->progressBar->setValue(0);
+    ui->labelThroughput->clear();
 }
 
 ///
@@ -688,8 +1155,33 @@ void DialogAddressScan::clearProgress()
 void DialogAddressScan::updateProgress()
 {
     const auto length = ui->lineEditLength->value<int>();
-    const int progress = 100.0 * _requestCount / length;
-    ui->progressBar->setValue(progress);
+    const int progress = 100.0 * _resolvedCount / length;
+    ui->progressBar->setValue(qMin(100, progress));
+}
+
+///
+/// \brief DialogAddressScan::updateThroughput
+///
+void DialogAddressScan::updateThroughput()
+{
+    const auto elapsed = _throughputTimer.isValid() ? _throughputTimer.elapsed() : 0;
+    if(elapsed <= 0 || _completedCount == 0)
+    {
+        ui->labelThroughput->clear();
+        return;
+    }
+
+    const auto length = ui->lineEditLength->value<int>();
+    const auto rate = 1000.0 * _completedCount / elapsed;
+
+    auto text = tr("%1 req/s").arg(rate, 0, 'f', 1);
+    if(_scanning && _resolvedCount > 0)
+    {
+        const qint64 eta = qMax(0, length - _resolvedCount) * elapsed / (1000.0 * _resolvedCount);
+        text += tr(", ETA %1").arg(QDateTime::fromSecsSinceEpoch(eta).toUTC().toString("hh:mm:ss"));
+    }
+
+    ui->labelThroughput->setText(text);
 }
 
 ///
@@ -701,21 +1193,16 @@ void DialogAddressScan::updateTableView(int pointAddress, QVector<quint16> value
 {
     auto model = ui->tableView->model();
 
+    // replies may complete out of order, so locate the cell directly from the address
+    const auto startAddress = ui->lineEditStartAddress->value<int>();
     const auto addressBase = ui->comboBoxAddressBase->currentAddressBase();
-    pointAddress += (addressBase == AddressBase::Base0 ? 0 : 1);
+    const auto idx = pointAddress - (addressBase == AddressBase::Base0 ? startAddress : startAddress - 1);
+    if(idx < 0 || idx >= ui->lineEditLength->value<int>())
+        return;
 
-    for(int i = 0; i < model->rowCount(); i++)
-    {
-        for(int j = 0; j < model->columnCount(); j++)
-        {
-            const auto index = model->index(i, j);
-            if(model->data(index, Qt::UserRole).toInt() == pointAddress)
-            {
-                model->setData(index, QVariant::fromValue(values), Qt::DisplayRole);
-                return;
-            }
-        }
-    }
+    const auto columns = model->columnCount();
+    const auto index = model->index(idx / columns, idx % columns);
+    model->setData(index, QVariant::fromValue(values), Qt::DisplayRole);
 }
 
 ///
@@ -789,22 +1276,68 @@ void DialogAddressScan::exportPdf(const QString& filename)
 }
 
 ///
-/// \brief DialogAddressScan::exportCsv
+/// \brief DialogAddressScan::exportStore
 /// \param filename
+/// \param format
 ///
-void DialogAddressScan::exportCsv(const QString& filename)
+void DialogAddressScan::exportStore(const QString& filename, StoreExporter::ExportFormat format)
 {
-    CsvExporter exporter(ui->tableView->model(),
-                         ui->comboBoxAddressBase->currentText(),
-                         ui->lineEditStartAddress->text(),
-                         ui->lineEditLength->text(),
-                         ui->lineEditSlaveAddress->text(),
-                         ui->comboBoxPointType->currentText(),
-                         ui->spinBoxRegsOnQuery->text(),
-                         ui->comboBoxByteOrder->currentText(),
-                         this);
+    if(_exporting)
+        return;
 
-    exporter.exportCsv(filename);
+    auto model = (TableViewItemModel*)ui->tableView->model();
+
+    // the exporter works on its own copy of the store, so scanning can go on meanwhile
+    auto exporter = new StoreExporter(model->store(),
+                                      format,
+                                      ui->comboBoxAddressBase->currentAddressBase(),
+                                      ui->comboBoxByteOrder->currentByteOrder(),
+                                      ui->checkBoxHexView->isChecked(),
+                                      model->columnCount(),
+                                      ui->lineEditSlaveAddress->value<int>(),
+                                      ui->comboBoxAddressBase->currentText(),
+                                      ui->lineEditStartAddress->text(),
+                                      ui->lineEditLength->text(),
+                                      ui->comboBoxPointType->currentText(),
+                                      ui->spinBoxRegsOnQuery->text(),
+                                      ui->comboBoxByteOrder->currentText());
+
+    _exportThread = new QThread(this);
+    exporter->moveToThread(_exportThread);
+
+    connect(_exportThread, &QThread::started, exporter, [exporter, filename]{
+        exporter->exportFile(filename);
+    });
+    connect(exporter, &StoreExporter::progress, ui->progressBar, &QProgressBar::setValue);
+    connect(exporter, &StoreExporter::finished, _exportThread, &QThread::quit);
+    connect(exporter, &StoreExporter::finished, this, [this](bool success){
+        _exporting = false;
+        updateControls();
+
+        if(!success)
+            QMessageBox::warning(this, windowTitle(), tr("Export failed!"));
+    });
+    connect(_exportThread, &QThread::finished, exporter, &QObject::deleteLater);
+    connect(_exportThread, &QThread::finished, _exportThread, &QObject::deleteLater);
+
+    _exporting = true;
+    ui->progressBar->setValue(0);
+    updateControls();
+
+    _exportThread->start();
+}
+
+///
+/// \brief DialogAddressScan::exportMap
+/// \param filename
+///
+void DialogAddressScan::exportMap(const QString& filename)
+{
+    AddressMapExporter exporter(_rangeMap,
+                                ui->comboBoxAddressBase->currentAddressBase(),
+                                this);
+
+    exporter.exportMap(filename);
 }
 
 ///
@@ -1054,30 +1587,47 @@ void PdfExporter::paintVLine(int top, int bottom, QPainter& painter)
 }
 
 ///
-/// \brief CsvExporter::CsvExporter
-/// \param model
+/// \brief StoreExporter::StoreExporter
+/// \param store
+/// \param format
+/// \param base
+/// \param order
+/// \param hexView
+/// \param columns
+/// \param deviceId
+/// \param addressBase
 /// \param startAddress
 /// \param length
-/// \param devId
 /// \param pointType
 /// \param regsOnQuery
+/// \param byteOrder
 /// \param parent
 ///
-CsvExporter::CsvExporter(QAbstractItemModel* model,
-                         const QString& addressBase,
-                         const QString& startAddress,
-                         const QString& length,
-                         const QString& devId,
-                         const QString& pointType,
-                         const QString& regsOnQuery,
-                         const QString& byteOrder,
-                         QObject* parent)
+StoreExporter::StoreExporter(const ModbusRegisterStore& store,
+                             ExportFormat format,
+                             AddressBase base,
+                             ByteOrder order,
+                             bool hexView,
+                             int columns,
+                             int deviceId,
+                             const QString& addressBase,
+                             const QString& startAddress,
+                             const QString& length,
+                             const QString& pointType,
+                             const QString& regsOnQuery,
+                             const QString& byteOrder,
+                             QObject* parent)
     : QObject(parent)
-    ,_model(model)
+    ,_store(store)
+    ,_format(format)
+    ,_base(base)
+    ,_order(order)
+    ,_hexView(hexView)
+    ,_columns(qMax(1, columns))
+    ,_deviceId(deviceId)
     ,_addressBase(addressBase)
     ,_startAddress(startAddress)
     ,_length(length)
-    ,_deviceId(devId)
     ,_pointType(pointType)
     ,_regsOnQuery(regsOnQuery)
     ,_byteOrder(byteOrder)
@@ -1085,36 +1635,221 @@ CsvExporter::CsvExporter(QAbstractItemModel* model,
 }
 
 ///
-/// \brief CsvExporter::exportCsv
+/// \brief StoreExporter::exportFile
 /// \param filename
 ///
-void CsvExporter::exportCsv(const QString& filename)
+void StoreExporter::exportFile(const QString& filename)
 {
-    QFile file(filename);
+    QSaveFile file(filename);
     if(!file.open(QFile::WriteOnly))
+    {
+        emit finished(false);
         return;
+    }
 
-    QTextStream ts(&file);
+    bool success = false;
+    switch(_format)
+    {
+        case Csv:
+            success = exportCsv(file);
+        break;
+
+        case Binary:
+            success = exportBinary(file);
+        break;
+    }
+
+    // an interrupted or failed export leaves the previous file untouched
+    if(success)
+        success = file.commit();
+    else
+        file.cancelWriting();
+
+    emit finished(success);
+}
+
+///
+/// \brief StoreExporter::exportCsv
+/// \param device
+/// \return
+///
+bool StoreExporter::exportCsv(QIODevice& device)
+{
+    QTextStream ts(&device);
     ts.setGenerateByteOrderMark(true);
 
     const char* delim = ";";
     const auto header = QString("%2%1%3%1%4%1%5%1%6%1%7%1%8").arg(delim, tr("Address Base"), tr("Start Address"), tr("Device Id"), tr("Length"), tr("Point Type"), tr("Registers on Query"), tr("Byte Order"));
     ts << header << "\n";
 
-    const auto headerData = QString("%2%1%3%1%4%1%5%1%6%1%7%1%8").arg(delim, _addressBase, _startAddress, _deviceId, _length, _pointType, _regsOnQuery, _byteOrder);
+    const auto headerData = QString("%2%1%3%1%4%1%5%1%6%1%7%1%8").arg(delim, _addressBase, _startAddress, QString::number(_deviceId), _length, _pointType, _regsOnQuery, _byteOrder);
     ts << headerData << "\n";
 
     ts << "\n";
 
-    for(int j = 0; j < _model->columnCount(); j++)
-        ts << delim << QString("=\"%1\"").arg(_model->headerData(j, Qt::Horizontal, Qt::DisplayRole).toString());
+    for(int j = 0; j < _columns; j++)
+        ts << delim << QString("=\"+%1\"").arg(j);
 
-    for(int i = 0; i < _model->rowCount(); i++)
+    const auto length = _store.valueCount();
+    const auto pointType = _store.registerType();
+    const auto pointAddress = _store.startAddress() + (_base == AddressBase::Base0 ? 0 : 1);
+
+    for(int i = 0; i < length; i += _columns)
     {
-        ts << "\n" << _model->headerData(i, Qt::Vertical, Qt::DisplayRole).toString();
-        for(int j = 0; j < _model->columnCount(); j++)
+        const auto addressFrom = pointAddress + i;
+        const auto addressTo = pointAddress + qMin(length, i + _columns) - 1;
+        ts << "\n" << formatAddress(pointType, addressFrom, false) << "-" << formatAddress(pointType, addressTo, false);
+
+        for(int j = i; j < i + _columns && j < length; j++)
+        {
+            ts << delim;
+            if(!_store.hasValue(j))
+            {
+                ts << "-";
+                continue;
+            }
+
+            // the same formatting the table view shows
+            QVariant outValue;
+            auto result = _hexView ? formatHexValue(pointType, _store.value(j), _order, outValue) :
+                                    formatUInt16Value(pointType, _store.value(j), _order, outValue);
+            ts << result.remove('<').remove('>');
+        }
+
+        if(!updateProgress(i + _columns))
+            return false;
+    }
+
+    ts.flush();
+    return ts.status() == QTextStream::Ok;
+}
+
+///
+/// \brief StoreExporter::exportBinary
+/// \param device
+/// \return
+///
+bool StoreExporter::exportBinary(QIODevice& device)
+{
+    const quint32 count = _store.valueCount();
+
+    // header followed by three columns: addresses, raw words and the validity bitmap
+    QDataStream out(&device);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << quint32(0x5243534F); // "OSCR"
+    out << quint16(1);
+    out << quint8(_store.registerType());
+    out << quint8(_deviceId);
+    out << quint32(_store.startAddress());
+    out << count;
+
+    for(quint32 i = 0; i < count; i++)
+        out << quint16(_store.startAddress() + i);
+
+    if(!updateProgress(count / 3))
+        return false;
+
+    for(quint32 i = 0; i < count; i++)
+        out << _store.value(i);
+
+    if(!updateProgress(2 * count / 3))
+        return false;
+
+    for(quint32 i = 0; i < count; i += 8)
+    {
+        quint8 bits = 0;
+        for(quint32 j = 0; j < 8 && i + j < count; j++)
+        {
+            if(_store.hasValue(i + j))
+                bits |= (1 << j);
+        }
+        out << bits;
+    }
+
+    updateProgress(count);
+    return out.status() == QDataStream::Ok;
+}
+
+///
+/// \brief StoreExporter::updateProgress
+/// \param done
+/// \return false if the export has been interrupted
+///
+bool StoreExporter::updateProgress(int done)
+{
+    const auto count = _store.valueCount();
+    const int progress = count > 0 ? 100.0 * qMin(done, count) / count : 100;
+    if(progress != _progress)
+    {
+        _progress = progress;
+        emit this->progress(progress);
+    }
+
+    return !QThread::currentThread()->isInterruptionRequested();
+}
+
+///
+/// \brief AddressMapExporter::AddressMapExporter
+/// \param map
+/// \param addressBase
+/// \param parent
+///
+AddressMapExporter::AddressMapExporter(const AddressRangeMap& map,
+                                       AddressBase addressBase,
+                                       QObject* parent)
+    : QObject(parent)
+    ,_map(map)
+    ,_addressBase(addressBase)
+{
+}
+
+///
+/// \brief AddressMapExporter::exportMap
+/// \param filename
+///
+void AddressMapExporter::exportMap(const QString& filename)
+{
+    QFile file(filename);
+    if(!file.open(QFile::WriteOnly))
+        return;
+
+    QTextStream ts(&file);
+    ts.setGenerateByteOrderMark(true);
+
+    const char* delim = ";";
+    const auto offset = (_addressBase == AddressBase::Base0 ? 0 : 1);
+
+    ts << QString("%2%1%3").arg(delim, tr("Device Id"), QString::number(_map.deviceId())) << "\n";
+    ts << "\n";
+    ts << QString("%2%1%3%1%4%1%5").arg(delim, tr("Point Type"), tr("Start Address"), tr("End Address"), tr("Length")) << "\n";
+
+    for(auto&& pointType : _map.pointTypes())
+    {
+        QString name;
+        switch(pointType)
+        {
+            case QModbusDataUnit::Coils:
+                name = tr("Coils");
+            break;
+            case QModbusDataUnit::DiscreteInputs:
+                name = tr("Discrete Inputs");
+            break;
+            case QModbusDataUnit::HoldingRegisters:
+                name = tr("Holding Registers");
+            break;
+            case QModbusDataUnit::InputRegisters:
+                name = tr("Input Registers");
+            break;
+            default:
+            break;
+        }
+
+        for(auto&& range : _map.ranges(pointType))
         {
-            ts << delim << _model->data(_model->index(i, j), Qt::DisplayRole).toString();
+            ts << QString("%2%1%3%1%4%1%5").arg(delim, name,
+                                                formatAddress(pointType, range.from() + offset, false),
+                                                formatAddress(pointType, range.to() + offset, false),
+                                                QString::number(range.to() - range.from() + 1)) << "\n";
         }
     }
 }
@@ -3,11 +3,18 @@
 
 #include <QDialog>
 #include <QTimer>
+#include <QQueue>
+#include <QThread>
+#include <QPointer>
 #include <QPrinter>
+#include <QCache>
+#include <QElapsedTimer>
+#include <QTemporaryFile>
 #include <QAbstractTableModel>
 #include <QSortFilterProxyModel>
+#include "qrange.h"
 #include "modbusmessage.h"
-#include "modbusdataunit.h"
+#include "modbusregisterstore.h"
 #include "modbusclient.h"
 #include "displaydefinition.h"
 
@@ -35,31 +42,29 @@ public:
     AddressBase addressBse() const;
     void setAddressBase(AddressBase base);
 
-    void reset(const ModbusDataUnit& data, int columns = 10){
-        beginResetModel();
-        _columns = columns;
-        _data = data;
-        endResetModel();
+    void reset(const ModbusRegisterStore& data, int columns = 10);
+
+    const ModbusRegisterStore& store() const {
+        return _data;
     }
 
     void setHexView(bool on){
-        beginResetModel();
         _hexView = on;
-        endResetModel();
+        updateAll();
     }
 
     void setByteOrder(ByteOrder order){
-        beginResetModel();
         _byteOrder = order;
-        endResetModel();
+        updateAll();
     }
 
 private:
     int getAddress(int idx) const;
+    void updateAll();
 
 private:
     int _columns = 10;
-    ModbusDataUnit _data;
+    ModbusRegisterStore _data;
     bool _hexView = false;
     AddressBase _addressBase = AddressBase::Base1;
     ByteOrder _byteOrder = ByteOrder::LittleEndian;
@@ -73,6 +78,10 @@ class LogViewModel : public QAbstractListModel
     Q_OBJECT
 
 public:
+    static const int MaxItems = 10000;
+    static const int SpillBatch = 1000;
+    static const int CacheSize = 512;
+
     explicit LogViewModel(QObject* parent = nullptr);
     ~LogViewModel();
 
@@ -82,18 +91,10 @@ public:
     AddressBase addressBse() const;
     void setAddressBase(AddressBase base);
 
-    void append(quint16 addr, QModbusDataUnit::RegisterType type, const ModbusMessage* msg) {
-        if(msg == nullptr) return;
-        beginInsertRows(QModelIndex(), rowCount(), rowCount());
-        _items.push_back({ addr, type, msg });
-        endInsertRows();
-    }
+    void append(quint16 addr, QModbusDataUnit::RegisterType type, const ModbusMessage* msg);
+    void clear();
 
-    void clear() {
-        beginResetModel();
-        deleteItems();
-        endResetModel();
-    }
+    bool isValidResponse(int row) const;
 
     void setHexView(bool on) {
         beginResetModel();
@@ -101,9 +102,6 @@ public:
         endResetModel();
     }
 
-private:
-    void deleteItems();
-
 private:
     struct LogViewItem{
         quint16 Addr;
@@ -111,10 +109,24 @@ private:
         const ModbusMessage* Msg;
     };
 
+    struct LogViewCachedItem : LogViewItem{
+        ~LogViewCachedItem() { delete Msg; }
+    };
+
+private:
+    void deleteItems();
+    void spillItems();
+    const LogViewItem* item(int row) const;
+
 private:
     bool _hexView = false;
     AddressBase _addressBase = AddressBase::Base1;
-    QVector<LogViewItem> _items;
+    QQueue<LogViewItem> _items;
+    QVector<qint64> _offsets;
+    QVector<quint64> _validBits;
+    int _count = 0;
+    QTemporaryFile _file;
+    mutable QCache<int, LogViewCachedItem> _cache;
 };
 
 ///
@@ -208,35 +220,102 @@ private:
 };
 
 ///
-/// \brief The CsvExporter class
+/// \brief The StoreExporter class
 ///
-class CsvExporter: public QObject
+class StoreExporter: public QObject
 {
     Q_OBJECT
 
 public:
-    explicit CsvExporter(QAbstractItemModel* model,
-                         const QString& addressBase,
-                         const QString& startAddress,
-                         const QString& length,
-                         const QString& devId,
-                         const QString& pointType,
-                         const QString& regsOnQuery,
-                         const QString& byteOrder,
-                         QObject* parent = nullptr);
-    void exportCsv(const QString& filename);
+    enum ExportFormat
+    {
+        Csv = 0,
+        Binary
+    };
+
+    explicit StoreExporter(const ModbusRegisterStore& store,
+                           ExportFormat format,
+                           AddressBase base,
+                           ByteOrder order,
+                           bool hexView,
+                           int columns,
+                           int deviceId,
+                           const QString& addressBase,
+                           const QString& startAddress,
+                           const QString& length,
+                           const QString& pointType,
+                           const QString& regsOnQuery,
+                           const QString& byteOrder,
+                           QObject* parent = nullptr);
+
+public slots:
+    void exportFile(const QString& filename);
+
+signals:
+    void progress(int value);
+    void finished(bool success);
 
 private:
-    QAbstractItemModel* _model;
+    bool exportCsv(QIODevice& device);
+    bool exportBinary(QIODevice& device);
+    bool updateProgress(int done);
+
+private:
+    int _progress = -1;
+    const ModbusRegisterStore _store;
+    const ExportFormat _format;
+    const AddressBase _base;
+    const ByteOrder _order;
+    const bool _hexView;
+    const int _columns;
+    const int _deviceId;
     const QString _addressBase;
     const QString _startAddress;
     const QString _length;
-    const QString _deviceId;
     const QString _pointType;
     const QString _regsOnQuery;
     const QString _byteOrder;
 };
 
+///
+/// \brief The AddressRangeMap class
+///
+class AddressRangeMap
+{
+public:
+    int deviceId() const { return _deviceId; }
+    void setDeviceId(int deviceId);
+
+    bool isEmpty() const;
+    void clear(QModbusDataUnit::RegisterType pointType);
+    void add(QModbusDataUnit::RegisterType pointType, int address, int count);
+
+    QList<QModbusDataUnit::RegisterType> pointTypes() const;
+    QVector<QRange<int>> ranges(QModbusDataUnit::RegisterType pointType) const;
+
+private:
+    int _deviceId = 0;
+    QMap<QModbusDataUnit::RegisterType, QMap<int, int>> _ranges;
+};
+
+///
+/// \brief The AddressMapExporter class
+///
+class AddressMapExporter: public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AddressMapExporter(const AddressRangeMap& map,
+                                AddressBase addressBase,
+                                QObject* parent = nullptr);
+    void exportMap(const QString& filename);
+
+private:
+    const AddressRangeMap& _map;
+    const AddressBase _addressBase;
+};
+
 ///
 /// \brief The DialogAddressScan class
 ///
@@ -252,12 +331,13 @@ protected:
     void changeEvent(QEvent* event) override;
 
 private slots:
-    void on_awake();
     void on_timeout();
     void on_modbusReply(QModbusReply* reply);
     void on_modbusRequest(int requestId, int deviceId, int transactionId, const QModbusRequest& data);
+    void on_modbusError(const QString& error, int requestId);
     void on_checkBoxHexView_toggled(bool);
     void on_checkBoxShowValid_toggled(bool);
+    void on_checkBoxDiscovery_toggled(bool);
     void on_lineEditStartAddress_valueChanged(const QVariant& value);
     void on_lineEditLength_valueChanged(const QVariant& value);
     void on_comboBoxPointType_pointTypeChanged(QModbusDataUnit::RegisterType pointType);
@@ -270,8 +350,15 @@ private slots:
 private:
     void startScan();
     void stopScan();
+    void updateControls();
 
-    void sendReadRequest();
+    bool sendReadRequest();
+    void fillPipeline();
+    void requestFinished();
+    int maxOutstanding() const;
+    int outstanding() const;
+    int blockSize() const;
+    bool splitBlock(const QModbusReply* reply, int address, int count);
 
     void clearTableView();
     void clearLogView();
@@ -279,23 +366,35 @@ private:
     void clearProgress();
 
     void updateProgress();
+    void updateThroughput();
     void updateTableView(int pointAddress, QVector<quint16> values);
 
     void updateLogView(int deviceId, int transactionId, const QModbusRequest& request);
     void updateLogView(const QModbusReply* reply);
 
     void exportPdf(const QString& filename);
-    void exportCsv(const QString& filename);
+    void exportStore(const QString& filename, StoreExporter::ExportFormat format);
+    void exportMap(const QString& filename);
 
 private:
     Ui::DialogAddressScan *ui;
 
 private:
     int _requestCount = 0;
+    int _completedCount = 0;
+    int _resolvedCount = 0;
+    QList<QPair<int, int>> _queuedBlocks;
+    QMap<int, int> _sentBlocks;
+    QQueue<QPair<int, int>> _splitBlocks;
+    AddressRangeMap _rangeMap;
+    QScopedPointer<const ModbusMessage> _selectedMessage;
+    QPointer<QThread> _exportThread;
     bool _scanning = false;
     bool _finished = false;
+    bool _exporting = false;
     quint64 _scanTime = 0;
     QTimer _scanTimer;
+    QElapsedTimer _throughputTimer;
     ModbusClient& _modbusClient;
 };
 
@@ -1,5 +1,9 @@
 #include <float.h>
 #include <QPushButton>
+#include <QFileDialog>
+#include <QMessageBox>
+#include "waveformgenerator.h"
+#include "simulationexpression.h"
 #include "dialogautosimulation.h"
 #include "ui_dialogautosimulation.h"
 
@@ -23,9 +27,20 @@ DialogAutoSimulation::DialogAutoSimulation(DataDisplayMode mode, ModbusSimulatio
     else
         ui->comboBoxSimulationType->setCurrentIndex(0);
 
-    ui->lineEditInterval->setInputRange(1, 60000);
+    ui->lineEditInterval->setInputRange(10, 3600000);
     ui->lineEditInterval->setValue(_params.Interval);
 
+    ui->lineEditPeriod->setInputRange(10, 86400000);
+    ui->lineEditPeriod->setValue(_params.WaveformParams.Period);
+    ui->lineEditPhase->setInputRange(-360., 360.);
+    ui->lineEditPhase->setInputMode(NumericLineEdit::DoubleMode);
+    ui->lineEditPhase->setValue(_params.WaveformParams.Phase);
+    ui->lineEditDutyCycle->setInputRange(1, 100);
+    ui->lineEditDutyCycle->setValue(qRound(_params.WaveformParams.DutyCycle));
+    ui->lineEditProfile->setText(_params.WaveformParams.ProfileFile);
+    _profile = _params.WaveformParams.Profile;
+    ui->lineEditExpression->setText(_params.ExpressionParams.Expression);
+
     switch(_displayMode)
     {
         case DataDisplayMode::Binary:
@@ -148,6 +163,41 @@ void DialogAutoSimulation::accept()
                                                                ui->lineEditHighLimit->value<double>());
             break;
 
+            case SimulationMode::Sine:
+            case SimulationMode::Triangle:
+            case SimulationMode::Square:
+            case SimulationMode::Ramp:
+            case SimulationMode::Noise:
+                _params.WaveformParams.Range = QRange<double>(ui->lineEditLowLimit->value<double>(),
+                                                              ui->lineEditHighLimit->value<double>());
+                _params.WaveformParams.Period = ui->lineEditPeriod->value<int>();
+                _params.WaveformParams.Phase = ui->lineEditPhase->value<double>();
+                _params.WaveformParams.DutyCycle = ui->lineEditDutyCycle->value<int>();
+            break;
+
+            case SimulationMode::Profile:
+                if(_profile.isEmpty())
+                {
+                    QMessageBox::warning(this, windowTitle(), tr("The profile has no points!"));
+                    return;
+                }
+                _params.WaveformParams.Phase = ui->lineEditPhase->value<double>();
+                _params.WaveformParams.ProfileFile = ui->lineEditProfile->text();
+                _params.WaveformParams.Profile = _profile;
+            break;
+
+            case SimulationMode::Expression:
+            {
+                SimulationExpression expression;
+                if(!expression.compile(ui->lineEditExpression->text()))
+                {
+                    QMessageBox::warning(this, windowTitle(), expression.errorString());
+                    return;
+                }
+                _params.ExpressionParams.Expression = ui->lineEditExpression->text();
+            }
+            break;
+
             default:
             break;
         }
@@ -175,6 +225,7 @@ void DialogAutoSimulation::on_checkBoxEnabled_toggled()
     ui->labelStepValue->setEnabled(enabled && mode != SimulationMode::Random);
     ui->lineEditStepValue->setEnabled(enabled && mode != SimulationMode::Random);
     ui->groupBoxSimulatioRange->setEnabled(enabled);
+    updateModeControls();
 }
 
 ///
@@ -185,6 +236,7 @@ void DialogAutoSimulation::on_comboBoxSimulationType_currentIndexChanged(int idx
 {
     ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(idx != -1);
     updateLimits();
+    updateModeControls();
 }
 
 ///
@@ -237,7 +289,67 @@ void DialogAutoSimulation::updateLimits()
             ui->lineEditHighLimit->setValue(_params.DecrementParams.Range.to());
         break;
 
+        case SimulationMode::Sine:
+        case SimulationMode::Triangle:
+        case SimulationMode::Square:
+        case SimulationMode::Ramp:
+        case SimulationMode::Noise:
+        case SimulationMode::Profile:
+        case SimulationMode::Expression:
+            ui->labelStepValue->setEnabled(false);
+            ui->lineEditStepValue->setEnabled(false);
+            ui->lineEditLowLimit->setValue(_params.WaveformParams.Range.from());
+            ui->lineEditHighLimit->setValue(_params.WaveformParams.Range.to());
+        break;
+
         default:
         break;
     }
 }
+
+///
+/// \brief DialogAutoSimulation::updateModeControls
+///
+void DialogAutoSimulation::updateModeControls()
+{
+    const bool enabled = ui->checkBoxEnabled->isChecked();
+    const auto mode = ui->comboBoxSimulationType->currentSimulationMode();
+    const bool periodic = mode >= SimulationMode::Sine && mode <= SimulationMode::Ramp;
+    const bool profile = mode == SimulationMode::Profile;
+    const bool duty = mode == SimulationMode::Square || mode == SimulationMode::Ramp;
+    const bool expression = mode == SimulationMode::Expression;
+
+    ui->labelExpression->setEnabled(enabled && expression);
+    ui->lineEditExpression->setEnabled(enabled && expression);
+    ui->groupBoxSimulatioRange->setEnabled(enabled && !profile && !expression);
+    ui->groupBoxWaveform->setEnabled(enabled && (periodic || profile));
+    ui->labelPeriod->setEnabled(periodic);
+    ui->lineEditPeriod->setEnabled(periodic);
+    ui->labelPhase->setEnabled(periodic || profile);
+    ui->lineEditPhase->setEnabled(periodic || profile);
+    ui->labelDutyCycle->setEnabled(duty);
+    ui->lineEditDutyCycle->setEnabled(duty);
+    ui->labelProfile->setEnabled(profile);
+    ui->lineEditProfile->setEnabled(profile);
+    ui->pushButtonProfile->setEnabled(profile);
+}
+
+///
+/// \brief DialogAutoSimulation::on_pushButtonProfile_clicked
+///
+void DialogAutoSimulation::on_pushButtonProfile_clicked()
+{
+    const auto filename = QFileDialog::getOpenFileName(this, QString(), ui->lineEditProfile->text(), tr("CSV files (*.csv);;All files (*)"));
+    if(filename.isEmpty())
+        return;
+
+    const auto profile = WaveformGenerator::loadProfile(filename);
+    if(profile.isEmpty())
+    {
+        QMessageBox::warning(this, windowTitle(), tr("No time and value pairs found in the file!"));
+        return;
+    }
+
+    _profile = profile;
+    ui->lineEditProfile->setText(filename);
+}
@@ -23,9 +23,11 @@ private slots:
     void on_comboBoxSimulationType_currentIndexChanged(int);
     void on_lineEditLowLimit_valueChanged(const QVariant&);
     void on_lineEditHighLimit_valueChanged(const QVariant&);
+    void on_pushButtonProfile_clicked();
 
 private:
     void updateLimits();
+    void updateModeControls();
 
 private:
     Ui::DialogAutoSimulation *ui;
@@ -33,6 +35,7 @@ private:
 private:
     ModbusSimulationParams& _params;
     DataDisplayMode _displayMode;
+    QVector<QPointF> _profile;
 };
 
 #endif // DIALOGAUTOSIMULATION_H
@@ -0,0 +1,76 @@
+#include <QPushButton>
+#include "dialogbulkwrite.h"
+#include "ui_dialogbulkwrite.h"
+
+///
+/// \brief DialogBulkWrite::DialogBulkWrite
+/// \param client
+/// \param pointType
+/// \param params
+/// \param verify
+/// \param parent
+///
+DialogBulkWrite::DialogBulkWrite(ModbusClient& client, QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params, bool verify, QWidget *parent)
+    : QFixedSizeDialog(parent)
+    , ui(new Ui::DialogBulkWrite)
+    ,_writer(client)
+    ,_unitName(pointType == QModbusDataUnit::Coils ? tr("coils") : tr("registers"))
+{
+    ui->setupUi(this);
+
+    connect(&_writer, &ModbusBulkWriter::progress, this, &DialogBulkWrite::on_progress);
+    connect(&_writer, &ModbusBulkWriter::finished, this, &DialogBulkWrite::on_finished);
+
+    _writer.start(pointType, params, verify);
+    if(_writer.inProgress())
+        on_progress();
+}
+
+///
+/// \brief DialogBulkWrite::~DialogBulkWrite
+///
+DialogBulkWrite::~DialogBulkWrite()
+{
+    delete ui;
+}
+
+///
+/// \brief DialogBulkWrite::reject
+///
+void DialogBulkWrite::reject()
+{
+    _writer.cancel();
+    QFixedSizeDialog::reject();
+}
+
+///
+/// \brief DialogBulkWrite::on_progress
+///
+void DialogBulkWrite::on_progress()
+{
+    const int total = _writer.total();
+    const int done = _writer.isVerifying() ? _writer.verified() : _writer.written();
+    const auto status = _writer.isVerifying() ? tr("Verifying %1 of %2 %3...") : tr("Writing %1 of %2 %3...");
+
+    ui->labelStatus->setText(status.arg(QString::number(done), QString::number(total), _unitName));
+    ui->progressBar->setRange(0, total);
+    ui->progressBar->setValue(done);
+    ui->labelThroughput->setText(tr("Throughput: %1 %2/s").arg(QString::number(_writer.throughput(), 'f', 0), _unitName));
+}
+
+///
+/// \brief DialogBulkWrite::on_finished
+///
+void DialogBulkWrite::on_finished()
+{
+    on_progress();
+
+    if(_writer.failed() > 0 || _writer.mismatched() > 0)
+        ui->labelStatus->setText(tr("Finished with errors: %1 failed, %2 mismatched").arg(_writer.failed()).arg(_writer.mismatched()));
+    else if(_writer.verified() > 0)
+        ui->labelStatus->setText(tr("%1 %2 written and verified").arg(_writer.written()).arg(_unitName));
+    else
+        ui->labelStatus->setText(tr("%1 %2 written").arg(_writer.written()).arg(_unitName));
+
+    ui->buttonBox->setStandardButtons(QDialogButtonBox::Close);
+}
@@ -0,0 +1,36 @@
+#ifndef DIALOGBULKWRITE_H
+#define DIALOGBULKWRITE_H
+
+#include "qfixedsizedialog.h"
+#include "modbusbulkwriter.h"
+
+namespace Ui {
+class DialogBulkWrite;
+}
+
+///
+/// \brief The DialogBulkWrite class shows the progress of a bulk write
+///
+class DialogBulkWrite : public QFixedSizeDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DialogBulkWrite(ModbusClient& client, QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params, bool verify, QWidget *parent = nullptr);
+    ~DialogBulkWrite();
+
+    void reject() override;
+
+private slots:
+    void on_progress();
+    void on_finished();
+
+private:
+    Ui::DialogBulkWrite *ui;
+
+private:
+    ModbusBulkWriter _writer;
+    QString _unitName;
+};
+
+#endif // DIALOGBULKWRITE_H
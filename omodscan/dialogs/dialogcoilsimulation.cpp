@@ -1,4 +1,6 @@
 #include <QPushButton>
+#include <QMessageBox>
+#include "simulationexpression.h"
 #include "dialogcoilsimulation.h"
 #include "ui_dialogcoilsimulation.h"
 
@@ -21,8 +23,9 @@ DialogCoilSimulation::DialogCoilSimulation(ModbusSimulationParams& params, QWidg
     else
         ui->comboBoxSimulationType->setCurrentIndex(0);
 
-    ui->lineEditInterval->setInputRange(1, 60000);
+    ui->lineEditInterval->setInputRange(10, 3600000);
     ui->lineEditInterval->setValue(_params.Interval);
+    ui->lineEditExpression->setText(_params.ExpressionParams.Expression);
     on_checkBoxEnabled_toggled();
 }
 
@@ -46,6 +49,17 @@ void DialogCoilSimulation::accept()
 
         if(_params.Mode == SimulationMode::Random)
             _params.RandomParams.Range = QRange<double>(0, 1);
+
+        if(_params.Mode == SimulationMode::Expression)
+        {
+            SimulationExpression expression;
+            if(!expression.compile(ui->lineEditExpression->text()))
+            {
+                QMessageBox::warning(this, windowTitle(), expression.errorString());
+                return;
+            }
+            _params.ExpressionParams.Expression = ui->lineEditExpression->text();
+        }
     }
     else
     {
@@ -64,6 +78,10 @@ void DialogCoilSimulation::on_checkBoxEnabled_toggled()
     ui->comboBoxSimulationType->setEnabled(enabled);
     ui->labelInterval->setEnabled(enabled);
     ui->lineEditInterval->setEnabled(enabled);
+
+    const bool expression = ui->comboBoxSimulationType->currentSimulationMode() == SimulationMode::Expression;
+    ui->labelExpression->setEnabled(enabled && expression);
+    ui->lineEditExpression->setEnabled(enabled && expression);
 }
 
 ///
@@ -73,4 +91,5 @@ void DialogCoilSimulation::on_checkBoxEnabled_toggled()
 void DialogCoilSimulation::on_comboBoxSimulationType_currentIndexChanged(int idx)
 {
     ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(idx != -1);
+    on_checkBoxEnabled_toggled();
 }
@@ -19,6 +19,13 @@ DialogDisplayDefinition::DialogDisplayDefinition(DisplayDefinition dd, QWidget*
     ui->lineEditLength->setInputRange(ModbusLimits::lengthRange());
     ui->lineEditSlaveAddress->setInputRange(ModbusLimits::slaveRange());
     ui->lineEditLogLimit->setInputRange(4, 1000);
+    ui->lineEditRefreshRate->setInputRange(33, 1000);
+    ui->lineEditHiddenScanRate->setInputRange(20, 3600000);
+
+    ui->comboBoxHiddenPolicy->addItem(tr("Full Rate"), QVariant::fromValue(PollingPolicy::FullRate));
+    ui->comboBoxHiddenPolicy->addItem(tr("Reduced Rate"), QVariant::fromValue(PollingPolicy::ReducedRate));
+    ui->comboBoxHiddenPolicy->addItem(tr("Data Only"), QVariant::fromValue(PollingPolicy::DataOnly));
+    ui->comboBoxHiddenPolicy->addItem(tr("Pause"), QVariant::fromValue(PollingPolicy::Pause));
 
     ui->comboBoxAddressBase->setCurrentAddressBase(dd.ZeroBasedAddress ? AddressBase::Base0 : AddressBase::Base1);
     ui->comboBoxPointType->setCurrentPointType(dd.PointType);
@@ -27,6 +34,10 @@ DialogDisplayDefinition::DialogDisplayDefinition(DisplayDefinition dd, QWidget*
     ui->lineEditSlaveAddress->setValue(dd.DeviceId);
     ui->lineEditLength->setValue(dd.Length);
     ui->lineEditLogLimit->setValue(dd.LogViewLimit);
+    ui->lineEditRefreshRate->setValue(dd.RefreshRate);
+    ui->lineEditHiddenScanRate->setValue(dd.HiddenScanRate);
+    ui->comboBoxHiddenPolicy->setCurrentIndex(ui->comboBoxHiddenPolicy->findData(QVariant::fromValue(dd.HiddenPolicy)));
+    ui->lineEditHiddenScanRate->setEnabled(dd.HiddenPolicy == PollingPolicy::ReducedRate);
 
     ui->buttonBox->setFocus();
 }
@@ -50,6 +61,9 @@ void DialogDisplayDefinition::accept()
     _displayDefinition.Length = ui->lineEditLength->value<int>();
     _displayDefinition.ScanRate = ui->lineEditScanRate->value<int>();
     _displayDefinition.LogViewLimit = ui->lineEditLogLimit->value<int>();
+    _displayDefinition.RefreshRate = ui->lineEditRefreshRate->value<int>();
+    _displayDefinition.HiddenPolicy = ui->comboBoxHiddenPolicy->currentData().value<PollingPolicy>();
+    _displayDefinition.HiddenScanRate = ui->lineEditHiddenScanRate->value<int>();
     _displayDefinition.ZeroBasedAddress = (ui->comboBoxAddressBase->currentAddressBase() == AddressBase::Base0);
 
     QFixedSizeDialog::accept();
@@ -66,3 +80,13 @@ void DialogDisplayDefinition::on_comboBoxAddressBase_addressBaseChanged(AddressB
     ui->lineEditPointAddress->setInputRange(ModbusLimits::addressRange(base == AddressBase::Base0));
     ui->lineEditPointAddress->setValue(base == AddressBase::Base1 ? qMax(1, addr + 1) : qMax(0, addr - 1));
 }
+
+///
+/// \brief DialogDisplayDefinition::on_comboBoxHiddenPolicy_currentIndexChanged
+/// \param index
+///
+void DialogDisplayDefinition::on_comboBoxHiddenPolicy_currentIndexChanged(int index)
+{
+    const auto policy = ui->comboBoxHiddenPolicy->itemData(index).value<PollingPolicy>();
+    ui->lineEditHiddenScanRate->setEnabled(policy == PollingPolicy::ReducedRate);
+}
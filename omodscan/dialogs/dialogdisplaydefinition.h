@@ -28,6 +28,7 @@ public:
 
 private slots:
     void on_comboBoxAddressBase_addressBaseChanged(AddressBase base);
+    void on_comboBoxHiddenPolicy_currentIndexChanged(int index);
 
 private:
     DisplayDefinition _displayDefinition;
@@ -0,0 +1,310 @@
+#include <QFileDialog>
+#include <QMessageBox>
+#include "modbuslimits.h"
+#include "formatutils.h"
+#include "dialogfiforeader.h"
+#include "ui_dialogfiforeader.h"
+
+///
+/// \brief FifoEntryModel::FifoEntryModel
+/// \param parent
+///
+FifoEntryModel::FifoEntryModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+///
+/// \brief FifoEntryModel::rowCount
+/// \return
+///
+int FifoEntryModel::rowCount(const QModelIndex&) const
+{
+    return _entries.size();
+}
+
+///
+/// \brief FifoEntryModel::columnCount
+/// \return
+///
+int FifoEntryModel::columnCount(const QModelIndex&) const
+{
+    return 3;
+}
+
+///
+/// \brief FifoEntryModel::data
+/// \param index
+/// \param role
+/// \return
+///
+QVariant FifoEntryModel::data(const QModelIndex& index, int role) const
+{
+    if(!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+
+    // the oldest entry sits at the head of the ring
+    const auto& entry = _entries.at((_head + index.row()) % _entries.size());
+    switch(role)
+    {
+        case Qt::DisplayRole:
+            switch(index.column())
+            {
+                case 0: return entry.Number;
+                case 1: return entry.Timestamp.toString(Qt::ISODateWithMs);
+                case 2: return formatUInt16Value(_hexView ? DataDisplayMode::Hex : DataDisplayMode::UInt16, entry.Value);
+            }
+        break;
+
+        case Qt::TextAlignmentRole:
+            return index.column() == 1 ? int(Qt::AlignLeft | Qt::AlignVCenter) : int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    return QVariant();
+}
+
+///
+/// \brief FifoEntryModel::headerData
+/// \param section
+/// \param orientation
+/// \param role
+/// \return
+///
+QVariant FifoEntryModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+
+    switch(section)
+    {
+        case 0: return tr("#");
+        case 1: return tr("Timestamp");
+        case 2: return tr("Value");
+    }
+
+    return QVariant();
+}
+
+///
+/// \brief FifoEntryModel::append
+/// \param timestamp
+/// \param values
+///
+void FifoEntryModel::append(const QDateTime& timestamp, const QVector<quint16>& values)
+{
+    int i = 0;
+
+    // grow until the capacity is reached
+    const int grow = qMin(values.size(), _capacity - _entries.size());
+    if(grow > 0)
+    {
+        beginInsertRows(QModelIndex(), _entries.size(), _entries.size() + grow - 1);
+        for(; i < grow; i++)
+            _entries.push_back({ _next++, timestamp, values[i] });
+        endInsertRows();
+    }
+
+    if(i == values.size())
+        return;
+
+    // then overwrite the oldest entries, the rows keep their count and shift up
+    for(; i < values.size(); i++)
+    {
+        _entries[_head] = { _next++, timestamp, values[i] };
+        _head = (_head + 1) % _entries.size();
+        _dropped++;
+    }
+    emit dataChanged(index(0, 0), index(_entries.size() - 1, columnCount() - 1));
+}
+
+///
+/// \brief FifoEntryModel::clear
+///
+void FifoEntryModel::clear()
+{
+    beginResetModel();
+    _entries.clear();
+    _head = 0;
+    _next = 0;
+    _dropped = 0;
+    endResetModel();
+}
+
+///
+/// \brief FifoEntryModel::setCapacity
+/// \param capacity
+///
+void FifoEntryModel::setCapacity(int capacity)
+{
+    if(capacity == _capacity)
+        return;
+
+    // keep the newest entries in order
+    QVector<FifoEntry> entries;
+    const int count = qMin(_entries.size(), capacity);
+    for(int i = _entries.size() - count; i < _entries.size(); i++)
+        entries.push_back(_entries.at((_head + i) % _entries.size()));
+
+    beginResetModel();
+    _dropped += _entries.size() - count;
+    _entries = entries;
+    _head = 0;
+    _capacity = qMax(1, capacity);
+    endResetModel();
+}
+
+///
+/// \brief DialogFifoReader::DialogFifoReader
+/// \param slaveAddress
+/// \param pointerAddress
+/// \param zeroBasedAddress
+/// \param client
+/// \param parent
+///
+DialogFifoReader::DialogFifoReader(quint8 slaveAddress, quint16 pointerAddress, bool zeroBasedAddress, ModbusClient& client, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::DialogFifoReader)
+    ,_zeroBasedAddress(zeroBasedAddress)
+    ,_reader(client)
+    ,_model(new FifoEntryModel(this))
+{
+    ui->setupUi(this);
+    setWindowFlags(Qt::Dialog |
+                   Qt::WindowCloseButtonHint |
+                   Qt::WindowMaximizeButtonHint);
+
+    ui->tableView->setModel(_model);
+    ui->lineEditSlaveAddress->setInputRange(ModbusLimits::slaveRange());
+    ui->lineEditPointerAddress->setPaddingZeroes(true);
+    ui->lineEditPointerAddress->setInputRange(ModbusLimits::addressRange(zeroBasedAddress));
+    ui->lineEditSlaveAddress->setValue(slaveAddress);
+    ui->lineEditPointerAddress->setValue(pointerAddress);
+    ui->spinBoxBufferSize->setValue(_model->capacity());
+
+    connect(&_reader, &ModbusFifoReader::entriesReceived, this, &DialogFifoReader::on_entriesReceived);
+    connect(&_reader, &ModbusFifoReader::errorOccurred, this, &DialogFifoReader::on_errorOccurred);
+
+    updateControls();
+    updateStatistics();
+}
+
+///
+/// \brief DialogFifoReader::~DialogFifoReader
+///
+DialogFifoReader::~DialogFifoReader()
+{
+    delete ui;
+}
+
+///
+/// \brief DialogFifoReader::on_pushButtonStart_clicked
+///
+void DialogFifoReader::on_pushButtonStart_clicked()
+{
+    if(_reader.isRunning())
+    {
+        _reader.stop();
+        updateControls();
+        return;
+    }
+
+    const int addr = ui->lineEditPointerAddress->value<int>();
+
+    FifoReadParams params;
+    params.DeviceId = ui->lineEditSlaveAddress->value<int>();
+    params.PointerAddress = _zeroBasedAddress ? addr : addr - 1;
+    params.Interval = ui->spinBoxInterval->value();
+    params.LogFile = ui->lineEditLogFile->text();
+
+    _model->setCapacity(ui->spinBoxBufferSize->value());
+    ui->labelStatus->clear();
+
+    if(!_reader.start(params))
+        QMessageBox::warning(this, windowTitle(), _reader.errorString());
+
+    updateControls();
+    updateStatistics();
+}
+
+///
+/// \brief DialogFifoReader::on_pushButtonClear_clicked
+///
+void DialogFifoReader::on_pushButtonClear_clicked()
+{
+    _model->clear();
+    updateStatistics();
+}
+
+///
+/// \brief DialogFifoReader::on_pushButtonBrowse_clicked
+///
+void DialogFifoReader::on_pushButtonBrowse_clicked()
+{
+    const auto filename = QFileDialog::getSaveFileName(this, QString(), ui->lineEditLogFile->text(), tr("Binary files (*.bin);;All files (*)"));
+    if(!filename.isEmpty())
+        ui->lineEditLogFile->setText(filename);
+}
+
+///
+/// \brief DialogFifoReader::on_checkBoxHexView_toggled
+/// \param checked
+///
+void DialogFifoReader::on_checkBoxHexView_toggled(bool checked)
+{
+    _model->setHexView(checked);
+}
+
+///
+/// \brief DialogFifoReader::on_entriesReceived
+/// \param timestamp
+/// \param values
+///
+void DialogFifoReader::on_entriesReceived(const QDateTime& timestamp, const QVector<quint16>& values)
+{
+    _model->append(timestamp, values);
+    if(ui->checkBoxAutoscroll->isChecked())
+        ui->tableView->scrollToBottom();
+
+    updateStatistics();
+}
+
+///
+/// \brief DialogFifoReader::on_errorOccurred
+/// \param error
+///
+void DialogFifoReader::on_errorOccurred(const QString& error)
+{
+    ui->labelStatus->setText(error);
+    updateControls();
+    updateStatistics();
+}
+
+///
+/// \brief DialogFifoReader::updateControls
+///
+void DialogFifoReader::updateControls()
+{
+    const bool running = _reader.isRunning();
+    ui->lineEditSlaveAddress->setEnabled(!running);
+    ui->lineEditPointerAddress->setEnabled(!running);
+    ui->spinBoxInterval->setEnabled(!running);
+    ui->spinBoxBufferSize->setEnabled(!running);
+    ui->lineEditLogFile->setEnabled(!running);
+    ui->pushButtonBrowse->setEnabled(!running);
+    ui->pushButtonStart->setText(running ? tr("Stop") : tr("Start"));
+}
+
+///
+/// \brief DialogFifoReader::updateStatistics
+///
+void DialogFifoReader::updateStatistics()
+{
+    ui->labelStatistics->setText(tr("Reads: %1  Entries: %2  Rate: %3/s  Max fill: %4  Full reads: %5  Dropped: %6  Errors: %7")
+                                 .arg(_reader.reads())
+                                 .arg(_reader.entries())
+                                 .arg(QString::number(_reader.drainRate(), 'f', 1))
+                                 .arg(_reader.maxFill())
+                                 .arg(_reader.overflows())
+                                 .arg(_model->dropped())
+                                 .arg(_reader.errors()));
+}
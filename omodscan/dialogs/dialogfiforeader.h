@@ -0,0 +1,91 @@
+#ifndef DIALOGFIFOREADER_H
+#define DIALOGFIFOREADER_H
+
+#include <QDialog>
+#include <QDateTime>
+#include <QAbstractTableModel>
+#include "modbusfiforeader.h"
+
+namespace Ui {
+class DialogFifoReader;
+}
+
+///
+/// \brief The FifoEntryModel class keeps the latest FIFO entries in a ring buffer
+///
+class FifoEntryModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit FifoEntryModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+    void append(const QDateTime& timestamp, const QVector<quint16>& values);
+    void clear();
+
+    int capacity() const { return _capacity; }
+    void setCapacity(int capacity);
+
+    quint64 dropped() const { return _dropped; }
+
+    void setHexView(bool on) {
+        beginResetModel();
+        _hexView = on;
+        endResetModel();
+    }
+
+private:
+    struct FifoEntry
+    {
+        quint64 Number;
+        QDateTime Timestamp;
+        quint16 Value;
+    };
+
+private:
+    bool _hexView = false;
+    int _capacity = 10000;
+    int _head = 0;
+    quint64 _next = 0;
+    quint64 _dropped = 0;
+    QVector<FifoEntry> _entries;
+};
+
+///
+/// \brief The DialogFifoReader class
+///
+class DialogFifoReader : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DialogFifoReader(quint8 slaveAddress, quint16 pointerAddress, bool zeroBasedAddress, ModbusClient& client, QWidget *parent = nullptr);
+    ~DialogFifoReader();
+
+private slots:
+    void on_pushButtonStart_clicked();
+    void on_pushButtonClear_clicked();
+    void on_pushButtonBrowse_clicked();
+    void on_checkBoxHexView_toggled(bool checked);
+    void on_entriesReceived(const QDateTime& timestamp, const QVector<quint16>& values);
+    void on_errorOccurred(const QString& error);
+
+private:
+    void updateControls();
+    void updateStatistics();
+
+private:
+    Ui::DialogFifoReader *ui;
+
+private:
+    bool _zeroBasedAddress;
+    ModbusFifoReader _reader;
+    FifoEntryModel* _model;
+};
+
+#endif // DIALOGFIFOREADER_H
@@ -0,0 +1,155 @@
+#include <QPushButton>
+#include <QFileDialog>
+#include <QMessageBox>
+#include "modbuslimits.h"
+#include "dialogfiletransfer.h"
+#include "ui_dialogfiletransfer.h"
+
+///
+/// \brief DialogFileTransfer::DialogFileTransfer
+/// \param slaveAddress
+/// \param client
+/// \param parent
+///
+DialogFileTransfer::DialogFileTransfer(quint8 slaveAddress, ModbusClient& client, QWidget *parent)
+    : QFixedSizeDialog(parent)
+    , ui(new Ui::DialogFileTransfer)
+    ,_transfer(client)
+{
+    ui->setupUi(this);
+
+    ui->comboBoxFunction->addItem(tr("20: READ FILE RECORD"));
+    ui->comboBoxFunction->addItem(tr("21: WRITE FILE RECORD"));
+    ui->lineEditSlaveDevice->setInputRange(ModbusLimits::slaveRange());
+    ui->lineEditFileNumber->setInputRange(ModbusLimits::fileNumberRange());
+    ui->lineEditStartRecord->setInputRange(ModbusLimits::recordNumberRange());
+    ui->lineEditRecordCount->setInputRange(1, ModbusLimits::recordNumberRange().to() + 1);
+    ui->lineEditRecordLength->setInputRange(ModbusLimits::lengthRange());
+
+    ui->lineEditSlaveDevice->setValue(slaveAddress);
+    ui->lineEditFileNumber->setValue(1);
+    ui->lineEditStartRecord->setValue(0);
+    ui->lineEditRecordCount->setValue(1);
+    ui->lineEditRecordLength->setValue(1);
+
+    ui->buttonBox->button(QDialogButtonBox::Ok)->setText(tr("Start"));
+
+    connect(&_transfer, &ModbusFileTransfer::progress, this, &DialogFileTransfer::on_progress);
+    connect(&_transfer, &ModbusFileTransfer::finished, this, &DialogFileTransfer::on_finished);
+}
+
+///
+/// \brief DialogFileTransfer::~DialogFileTransfer
+///
+DialogFileTransfer::~DialogFileTransfer()
+{
+    delete ui;
+}
+
+///
+/// \brief DialogFileTransfer::accept
+///
+void DialogFileTransfer::accept()
+{
+    FileTransferParams params;
+    params.Write = ui->comboBoxFunction->currentIndex() == 1;
+    params.DeviceId = ui->lineEditSlaveDevice->value<int>();
+    params.FileNumber = ui->lineEditFileNumber->value<int>();
+    params.StartRecord = ui->lineEditStartRecord->value<int>();
+    params.RecordCount = ui->lineEditRecordCount->value<int>();
+    params.RecordLength = ui->lineEditRecordLength->value<int>();
+    params.IndexedRecords = ui->checkBoxIndexedRecords->isChecked();
+    params.FileName = ui->lineEditFile->text();
+
+    if(params.FileName.isEmpty())
+    {
+        QMessageBox::warning(this, windowTitle(), tr("Select a file to transfer"));
+        return;
+    }
+
+    // the dialog stays open and shows the progress
+    setControlsEnabled(false);
+    ui->labelStatus->clear();
+    _transfer.start(params);
+    if(_transfer.inProgress())
+        on_progress();
+}
+
+///
+/// \brief DialogFileTransfer::reject
+///
+void DialogFileTransfer::reject()
+{
+    if(_transfer.inProgress())
+    {
+        _transfer.cancel();
+        ui->labelStatus->setText(tr("Cancelled"));
+        setControlsEnabled(true);
+        return;
+    }
+
+    QFixedSizeDialog::reject();
+}
+
+///
+/// \brief DialogFileTransfer::on_pushButtonBrowse_clicked
+///
+void DialogFileTransfer::on_pushButtonBrowse_clicked()
+{
+    const auto filter = tr("Binary files (*.bin);;CSV files (*.csv);;All files (*)");
+    const auto filename = ui->comboBoxFunction->currentIndex() == 1 ?
+                              QFileDialog::getOpenFileName(this, QString(), ui->lineEditFile->text(), filter) :
+                              QFileDialog::getSaveFileName(this, QString(), ui->lineEditFile->text(), filter);
+
+    if(!filename.isEmpty())
+        ui->lineEditFile->setText(filename);
+}
+
+///
+/// \brief DialogFileTransfer::on_progress
+///
+void DialogFileTransfer::on_progress()
+{
+    const int total = _transfer.total();
+    const int done = _transfer.transferred();
+
+    ui->labelStatus->setText(tr("Transferred %1 of %2 registers...").arg(done).arg(total));
+    ui->progressBar->setRange(0, total);
+    ui->progressBar->setValue(done);
+    ui->labelThroughput->setText(tr("Throughput: %1 registers/s").arg(QString::number(_transfer.throughput(), 'f', 0)));
+}
+
+///
+/// \brief DialogFileTransfer::on_finished
+///
+void DialogFileTransfer::on_finished()
+{
+    if(_transfer.total() > 0)
+        on_progress();
+
+    if(!_transfer.errorString().isEmpty())
+        ui->labelStatus->setText(tr("Failed after %1 registers: %2").arg(_transfer.transferred()).arg(_transfer.errorString()));
+    else
+        ui->labelStatus->setText(tr("%1 registers transferred").arg(_transfer.transferred()));
+
+    setControlsEnabled(true);
+}
+
+///
+/// \brief DialogFileTransfer::setControlsEnabled
+/// \param enabled
+///
+void DialogFileTransfer::setControlsEnabled(bool enabled)
+{
+    ui->lineEditSlaveDevice->setEnabled(enabled);
+    ui->comboBoxFunction->setEnabled(enabled);
+    ui->lineEditFileNumber->setEnabled(enabled);
+    ui->lineEditStartRecord->setEnabled(enabled);
+    ui->lineEditRecordCount->setEnabled(enabled);
+    ui->lineEditRecordLength->setEnabled(enabled);
+    ui->checkBoxIndexedRecords->setEnabled(enabled);
+    ui->lineEditFile->setEnabled(enabled);
+    ui->pushButtonBrowse->setEnabled(enabled);
+    ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(enabled);
+    ui->buttonBox->button(QDialogButtonBox::Close)->setText(enabled ? tr("Close") : tr("Cancel"));
+}
@@ -0,0 +1,40 @@
+#ifndef DIALOGFILETRANSFER_H
+#define DIALOGFILETRANSFER_H
+
+#include "qfixedsizedialog.h"
+#include "modbusfiletransfer.h"
+
+namespace Ui {
+class DialogFileTransfer;
+}
+
+///
+/// \brief The DialogFileTransfer class drives file record transfers between a device and a local file
+///
+class DialogFileTransfer : public QFixedSizeDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DialogFileTransfer(quint8 slaveAddress, ModbusClient& client, QWidget *parent = nullptr);
+    ~DialogFileTransfer();
+
+    void accept() override;
+    void reject() override;
+
+private slots:
+    void on_pushButtonBrowse_clicked();
+    void on_progress();
+    void on_finished();
+
+private:
+    void setControlsEnabled(bool enabled);
+
+private:
+    Ui::DialogFileTransfer *ui;
+
+private:
+    ModbusFileTransfer _transfer;
+};
+
+#endif // DIALOGFILETRANSFER_H
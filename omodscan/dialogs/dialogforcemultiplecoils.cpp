@@ -1,6 +1,9 @@
 #include <QtMath>
 #include <QLineEdit>
+#include <QFileDialog>
+#include <QMessageBox>
 #include "formatutils.h"
+#include "modbusbulkwriter.h"
 #include "dialogforcemultiplecoils.h"
 #include "ui_dialogforcemultiplecoils.h"
 
@@ -23,7 +26,7 @@ DialogForceMultipleCoils::DialogForceMultipleCoils(ModbusWriteParams& params, in
     ui->labelLength->setText(QString(tr("Length: <b>%1</b>")).arg(length, 3, 10, QLatin1Char('0')));
     ui->labelSlaveDevice->setText(QString(tr("Slave Device: <b>%1</b>")).arg(params.Node, 2, 10, QLatin1Char('0')));
 
-    _data = params.Value.value<QVector<quint16>>();
+    _data = params.Value.toWords();
     if(_data.length() != length) _data.resize(length);
 
     updateTableWidget();
@@ -42,10 +45,42 @@ DialogForceMultipleCoils::~DialogForceMultipleCoils()
 ///
 void DialogForceMultipleCoils::accept()
 {
-    _writeParams.Value = QVariant::fromValue(_data);
+    _writeParams.Value = _data;
     QDialog::accept();
 }
 
+///
+/// \brief DialogForceMultipleCoils::verify
+/// \return
+///
+bool DialogForceMultipleCoils::verify() const
+{
+    return ui->checkBoxVerify->isChecked();
+}
+
+///
+/// \brief DialogForceMultipleCoils::on_pushButtonLoad_clicked
+///
+void DialogForceMultipleCoils::on_pushButtonLoad_clicked()
+{
+    const auto filename = QFileDialog::getOpenFileName(this, QString(), QString(), tr("Text files (*.txt *.csv);;All files (*)"));
+    if(filename.isEmpty())
+        return;
+
+    const auto values = ModbusBulkWriter::loadValues(filename);
+    if(values.isEmpty())
+    {
+        QMessageBox::warning(this, windowTitle(), tr("No values found in the file!"));
+        return;
+    }
+
+    // the file fills the block from its start, values beyond the length are dropped
+    for(int i = 0; i < qMin(values.size(), _data.size()); i++)
+        _data[i] = values[i] != 0;
+
+    updateTableWidget();
+}
+
 ///
 /// \brief DialogForceMultipleCoils::on_pushButton0_clicked
 ///
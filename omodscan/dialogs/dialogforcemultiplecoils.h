@@ -19,8 +19,11 @@ public:
 
     void accept() override;
 
+    bool verify() const;
+
 private slots:
     void on_pushButton0_clicked();
+    void on_pushButtonLoad_clicked();
     void on_pushButton1_clicked();
     void on_tableWidget_itemDoubleClicked(QTableWidgetItem *item);
 
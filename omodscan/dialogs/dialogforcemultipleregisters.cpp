@@ -1,6 +1,9 @@
 #include <QtMath>
 #include <QRandomGenerator>
+#include <QFileDialog>
+#include <QMessageBox>
 #include "formatutils.h"
+#include "modbusbulkwriter.h"
 #include "numericutils.h"
 #include "numericlineedit.h"
 #include "dialogforcemultipleregisters.h"
@@ -26,7 +29,7 @@ DialogForceMultipleRegisters::DialogForceMultipleRegisters(ModbusWriteParams& pa
     ui->labelLength->setText(QString(tr("Length: <b>%1</b>")).arg(length, 3, 10, QLatin1Char('0')));
     ui->labelSlaveDevice->setText(QString(tr("Slave Device: <b>%1</b>")).arg(params.Node, 2, 10, QLatin1Char('0')));
 
-    _data = params.Value.value<QVector<quint16>>();
+    _data = params.Value.toWords();
     if(_data.length() != length) _data.resize(length);
 
     updateTableWidget();
@@ -166,10 +169,42 @@ void DialogForceMultipleRegisters::accept()
         }
     }
 
-    _writeParams.Value = QVariant::fromValue(_data);
+    _writeParams.Value = _data;
     QDialog::accept();
 }
 
+///
+/// \brief DialogForceMultipleRegisters::verify
+/// \return
+///
+bool DialogForceMultipleRegisters::verify() const
+{
+    return ui->checkBoxVerify->isChecked();
+}
+
+///
+/// \brief DialogForceMultipleRegisters::on_pushButtonLoad_clicked
+///
+void DialogForceMultipleRegisters::on_pushButtonLoad_clicked()
+{
+    const auto filename = QFileDialog::getOpenFileName(this, QString(), QString(), tr("Text files (*.txt *.csv);;All files (*)"));
+    if(filename.isEmpty())
+        return;
+
+    const auto values = ModbusBulkWriter::loadValues(filename);
+    if(values.isEmpty())
+    {
+        QMessageBox::warning(this, windowTitle(), tr("No values found in the file!"));
+        return;
+    }
+
+    // the file fills the block from its start, values beyond the length are dropped
+    for(int i = 0; i < qMin(values.size(), _data.size()); i++)
+        _data[i] = values[i];
+
+    updateTableWidget();
+}
+
 ///
 /// \brief DialogForceMultipleRegisters::on_pushButton0_clicked
 ///
@@ -23,8 +23,11 @@ public:
 
     void accept() override;
 
+    bool verify() const;
+
 private slots:
     void on_pushButton0_clicked();
+    void on_pushButtonLoad_clicked();
     void on_pushButtonRandom_clicked();
 
 private:
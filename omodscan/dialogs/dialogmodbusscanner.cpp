@@ -3,7 +3,6 @@
 #include <QSerialPortInfo>
 #include <QHostInfo>
 #include <QNetworkInterface>
-#include <QAbstractEventDispatcher>
 #include "modbuslimits.h"
 #include "serialportutils.h"
 #include "modbusrtuscanner.h"
@@ -51,6 +50,7 @@ DialogModbusScanner::DialogModbusScanner(QWidget *parent)
     , ui(new Ui::DialogModbusScanner)
     ,_rtuFuncCode(QModbusPdu::ReportServerId)
     ,_tcpFuncCode(QModbusPdu::ReadHoldingRegisters)
+    ,_timeSaved(0)
     ,_iconStart(":/res/iconScanStart.png")
     ,_iconStop(":/res/iconScanStop.png")
 {
@@ -86,8 +86,7 @@ DialogModbusScanner::DialogModbusScanner(QWidget *parent)
     ui->comboBoxFunction->setCurrentFunctionCode(QModbusPdu::ReadHoldingRegisters);
     ui->comboBoxAddressBase->setCurrentAddressBase(AddressBase::Base1);
 
-    auto dispatcher = QAbstractEventDispatcher::instance();
-    connect(dispatcher, &QAbstractEventDispatcher::awake, this, &DialogModbusScanner::on_awake);
+    updateControls();
 }
 
 ///
@@ -121,13 +120,15 @@ void DialogModbusScanner::showEvent(QShowEvent* e)
 }
 
 ///
-/// \brief DialogRtuScanner::on_awake
+/// \brief DialogModbusScanner::updateControls
 ///
-void DialogModbusScanner::on_awake()
+void DialogModbusScanner::updateControls()
 {
     const bool inProgress = _scanner && _scanner->inProgress();
     const bool rtuScanning = ui->radioButtonRTU->isChecked();
-    ui->comboBoxSerial->setEnabled(!inProgress && rtuScanning);
+    ui->comboBoxSerial->setEnabled(!inProgress && rtuScanning && !ui->checkBoxAllPorts->isChecked());
+    ui->checkBoxAllPorts->setEnabled(!inProgress && rtuScanning && ui->comboBoxSerial->count() > 1);
+    ui->checkBoxAutoDetect->setEnabled(!inProgress && rtuScanning);
     ui->groupBoxConnection->setEnabled(!inProgress);
     ui->groupBoxBaudRate->setEnabled(!inProgress && rtuScanning);
     ui->groupBoxDataBits->setEnabled(!inProgress && rtuScanning);
@@ -135,9 +136,11 @@ void DialogModbusScanner::on_awake()
     ui->groupBoxStopBits->setEnabled(!inProgress && rtuScanning);
     ui->groupBoxDeviceId->setEnabled(!inProgress);
     ui->groupBoxTimeout->setEnabled(!inProgress);
+    ui->spinBoxMinTimeout->setEnabled(ui->checkBoxAdaptiveTimeout->isChecked());
     ui->groupBoxIPAddressRange->setEnabled(!inProgress);
     ui->groupBoxPortRange->setEnabled(!inProgress);
     ui->groupBoxSubnetMask->setEnabled(!inProgress);
+    ui->groupBoxConcurrency->setEnabled(!inProgress);
     ui->groupBoxRequest->setEnabled(!inProgress);
     ui->pushButtonClear->setEnabled(!inProgress);
     ui->pushButtonScan->setEnabled((rtuScanning && ui->comboBoxSerial->count() > 0) || !rtuScanning);
@@ -160,6 +163,7 @@ void DialogModbusScanner::on_pushButtonScan_clicked()
         startScan();
     }
 
+    updateControls();
     setCursor(Qt::ArrowCursor);
 }
 
@@ -171,6 +175,22 @@ void DialogModbusScanner::on_pushButtonClear_clicked()
     ui->listWidget->clear();
 }
 
+///
+/// \brief DialogModbusScanner::on_checkBoxAllPorts_toggled
+///
+void DialogModbusScanner::on_checkBoxAllPorts_toggled()
+{
+    updateControls();
+}
+
+///
+/// \brief DialogModbusScanner::on_checkBoxAdaptiveTimeout_toggled
+///
+void DialogModbusScanner::on_checkBoxAdaptiveTimeout_toggled()
+{
+    updateControls();
+}
+
 ///
 /// \brief DialogRtuScanner::on_errorOccurred
 /// \param error
@@ -264,10 +284,12 @@ void DialogModbusScanner::on_radioButtonRTU_clicked()
     ui->labelStopBits->setVisible(true);
     ui->groupBoxPortRange->setVisible(false);
     ui->groupBoxSubnetMask->setVisible(false);
+    ui->groupBoxConcurrency->setVisible(false);
     ui->labelIPAddress->setVisible(false);
     ui->labelPort->setVisible(false);
     ui->labelScanResultsDesc->setText(tr("PORT: Device Id (serial port settings)"));
     ui->comboBoxFunction->setCurrentFunctionCode(_rtuFuncCode);
+    updateControls();
 }
 
 ///
@@ -278,6 +300,7 @@ void DialogModbusScanner::on_radioButtonTCP_clicked()
     ui->groupBoxIPAddressRange->setVisible(true);
     ui->groupBoxPortRange->setVisible(true);
     ui->groupBoxSubnetMask->setVisible(true);
+    ui->groupBoxConcurrency->setVisible(true);
     ui->labelIPAddress->setVisible(true);
     ui->labelPort->setVisible(true);
     ui->groupBoxSerialPort->setVisible(false);
@@ -287,6 +310,7 @@ void DialogModbusScanner::on_radioButtonTCP_clicked()
     ui->labelStopBits->setVisible(false);
     ui->labelScanResultsDesc->setText(tr("Address: port (Device Id)"));
     ui->comboBoxFunction->setCurrentFunctionCode(_tcpFuncCode);
+    updateControls();
 }
 
 ///
@@ -313,6 +337,7 @@ void DialogModbusScanner::startScan()
     }
 
     connect(_scanner.get(), &ModbusScanner::timeout, this, &DialogModbusScanner::on_timeout);
+    connect(_scanner.get(), &ModbusScanner::timeSaved, this, &DialogModbusScanner::on_timeSaved, Qt::QueuedConnection);
     connect(_scanner.get(), &ModbusScanner::finished, this, &DialogModbusScanner::on_scanFinished, Qt::QueuedConnection);
     connect(_scanner.get(), &ModbusScanner::errorOccurred, this, &DialogModbusScanner::on_errorOccurred, Qt::QueuedConnection);
     connect(_scanner.get(), &ModbusScanner::found, this, &DialogModbusScanner::on_deviceFound, Qt::QueuedConnection);
@@ -349,6 +374,9 @@ void DialogModbusScanner::stopScan()
 void DialogModbusScanner::clearScanTime()
 {
     on_timeout(0);
+
+    _timeSaved = 0;
+    on_timeSaved(0);
 }
 
 ///
@@ -485,22 +513,36 @@ const ScanParams DialogModbusScanner::createSerialParams() const
             stopBits.push_back((QSerialPort::StopBits)chbx->text().toInt());
     }
 
-    for(auto&& baudRate : baudRates)
+    QStringList portNames;
+    if(ui->checkBoxAllPorts->isChecked())
     {
-        for(auto&& wordLength : dataBits)
+        for(int i = 0; i < ui->comboBoxSerial->count(); i++)
+            portNames.push_back(ui->comboBoxSerial->itemText(i));
+    }
+    else
+    {
+        portNames.push_back(ui->comboBoxSerial->currentText());
+    }
+
+    for(auto&& portName : portNames)
+    {
+        for(auto&& baudRate : baudRates)
         {
-            for(auto&& parity : parities)
+            for(auto&& wordLength : dataBits)
             {
-                for(auto&& stop : stopBits)
+                for(auto&& parity : parities)
                 {
-                    ConnectionDetails cd;
-                    cd.Type = ConnectionType::Serial;
-                    cd.SerialParams.PortName = ui->comboBoxSerial->currentText();
-                    cd.SerialParams.BaudRate = baudRate;
-                    cd.SerialParams.WordLength = wordLength;
-                    cd.SerialParams.Parity = parity;
-                    cd.SerialParams.StopBits = stop;
-                    params.ConnParams.append(cd);
+                    for(auto&& stop : stopBits)
+                    {
+                        ConnectionDetails cd;
+                        cd.Type = ConnectionType::Serial;
+                        cd.SerialParams.PortName = portName;
+                        cd.SerialParams.BaudRate = baudRate;
+                        cd.SerialParams.WordLength = wordLength;
+                        cd.SerialParams.Parity = parity;
+                        cd.SerialParams.StopBits = stop;
+                        params.ConnParams.append(cd);
+                    }
                 }
             }
         }
@@ -513,7 +555,10 @@ const ScanParams DialogModbusScanner::createSerialParams() const
     params.Request = createModbusRequest();
     params.Timeout = ui->spinBoxTimeout->value();
     params.RetryOnTimeout = ui->checkBoxRetryOnTimeout->isChecked();
+    params.AdaptiveTimeout = ui->checkBoxAdaptiveTimeout->isChecked();
+    params.MinTimeout = ui->spinBoxMinTimeout->value();
     params.DeviceIds = QRange<int>(ui->spinBoxDeviceIdFrom->value(), ui->spinBoxDeviceIdTo->value());
+    params.AutoDetect = ui->checkBoxAutoDetect->isChecked();
 
     return params;
 }
@@ -577,7 +622,14 @@ const ScanParams DialogModbusScanner::createTcpParams() const
     params.Request = createModbusRequest();
     params.Timeout = ui->spinBoxTimeout->value();
     params.RetryOnTimeout = ui->checkBoxRetryOnTimeout->isChecked();
+    params.AdaptiveTimeout = ui->checkBoxAdaptiveTimeout->isChecked();
+    params.MinTimeout = ui->spinBoxMinTimeout->value();
     params.DeviceIds = QRange<int>(ui->spinBoxDeviceIdFrom->value(), ui->spinBoxDeviceIdTo->value());
+    params.MaxConcurrentHosts = ui->spinBoxConcurrentHosts->value();
+    params.MaxProbesPerHost = ui->spinBoxProbesPerHost->value();
+    params.MaxInFlight = ui->spinBoxMaxInFlight->value();
+    params.ConnectRate = ui->spinBoxConnectRate->value();
+    params.MaxPendingConnects = ui->spinBoxPendingConnects->value();
 
     return params;
 }
@@ -616,6 +668,7 @@ void DialogModbusScanner::on_scanFinished()
 {
     ui->pushButtonScan->setIcon(_iconStart);
     clearProgress();
+    updateControls();
 }
 
 ///
@@ -627,3 +680,15 @@ void DialogModbusScanner::on_timeout(quint64 time)
     const auto str = QDateTime::fromSecsSinceEpoch(time).toUTC().toString("hh:mm:ss");
     ui->labelTimeLeft->setText(QString("<html><head/><body><p><span style=\"font-weight:700;\">%1</span></p></body></html>").arg(str));
 }
+
+///
+/// \brief DialogModbusScanner::on_timeSaved
+/// \param msec
+///
+void DialogModbusScanner::on_timeSaved(quint64 msec)
+{
+    _timeSaved += msec;
+
+    const auto str = QDateTime::fromMSecsSinceEpoch(_timeSaved).toUTC().toString("hh:mm:ss");
+    ui->labelTimeSaved->setText(QString(tr("Saved: %1")).arg(str));
+}
@@ -30,9 +30,9 @@ signals:
     void attemptToConnect(const ConnectionDetails& params, int deviceId);
 
 private slots:
-    void on_awake();
     void on_scanFinished();
     void on_timeout(quint64 time);
+    void on_timeSaved(quint64 msec);
     void on_errorOccurred(const QString& error);
     void on_deviceFound(const ConnectionDetails& cd, int deviceId, bool dubious);
     void on_progress(const ConnectionDetails& cd, int deviceId, int progress);
@@ -44,6 +44,8 @@ private slots:
     void on_lineEditSubnetMask_editingFinished();
     void on_pushButtonScan_clicked();
     void on_pushButtonClear_clicked();
+    void on_checkBoxAllPorts_toggled();
+    void on_checkBoxAdaptiveTimeout_toggled();
     void on_radioButtonRTU_clicked();
     void on_radioButtonTCP_clicked();
 
@@ -51,6 +53,7 @@ private slots:
 private:
     void startScan();
     void stopScan();
+    void updateControls();
 
     void clearScanTime();
     void clearProgress();
@@ -64,6 +67,7 @@ private:
     QModbusPdu::FunctionCode _rtuFuncCode;
     QModbusPdu::FunctionCode _tcpFuncCode;
     QScopedPointer<ModbusScanner> _scanner;
+    quint64 _timeSaved;
     QIcon _iconStart;
     QIcon _iconStop;
 };
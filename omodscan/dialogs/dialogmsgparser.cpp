@@ -1,5 +1,4 @@
 #include <QPushButton>
-#include <QAbstractEventDispatcher>
 #include "dialogmsgparser.h"
 #include "ui_dialogmsgparser.h"
 
@@ -24,9 +23,7 @@ DialogMsgParser::DialogMsgParser(DataDisplayMode mode, ModbusMessage::ProtocolTy
     ui->hexView->setCheckState(mode == DataDisplayMode::Hex ? Qt::Checked : Qt::Unchecked);
     ui->buttonRtu->setChecked(protocol == ModbusMessage::Rtu);
     ui->buttonTcp->setChecked(protocol == ModbusMessage::Tcp);
-
-    auto dispatcher = QAbstractEventDispatcher::instance();
-    connect(dispatcher, &QAbstractEventDispatcher::awake, this, &DialogMsgParser::on_awake);
+    ui->pushButtonParse->setEnabled(false);
 }
 
 ///
@@ -52,14 +49,6 @@ void DialogMsgParser::changeEvent(QEvent* event)
     QDialog::changeEvent(event);
 }
 
-///
-/// \brief DialogMsgParser::on_awake
-///
-void DialogMsgParser::on_awake()
-{
-    ui->pushButtonParse->setEnabled(!ui->bytesData->isEmpty());
-}
-
 ///
 /// \brief DialogMsgParser::on_hexView_toggled
 /// \param checked
@@ -76,6 +65,8 @@ void DialogMsgParser::on_hexView_toggled(bool checked)
 ///
 void DialogMsgParser::on_bytesData_valueChanged(const QByteArray& value)
 {
+    ui->pushButtonParse->setEnabled(!value.isEmpty());
+
     if(value.size() < 3)
     {
         if(value.isEmpty())
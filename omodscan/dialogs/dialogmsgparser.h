@@ -24,7 +24,6 @@ protected:
     void changeEvent(QEvent* event) override;
 
 private slots:
-    void on_awake();
     void on_hexView_toggled(bool);
     void on_bytesData_valueChanged(const QByteArray& value);
     void on_pushButtonParse_clicked();
@@ -24,11 +24,11 @@ DialogSetupPresetData::DialogSetupPresetData(SetupPresetParams& params,  QModbus
     {
         case QModbusDataUnit::Coils:
             setWindowTitle("15: FORCE MULTIPLE COILS");
-            ui->lineEditNumberOfPoints->setInputRange(1, 1968);
+            ui->lineEditNumberOfPoints->setInputRange(ModbusLimits::bulkLengthRange());
         break;
         case QModbusDataUnit::HoldingRegisters:
             setWindowTitle("16: FORCE MULTIPLE REGISTERS");
-            ui->lineEditNumberOfPoints->setInputRange(1, 123);
+            ui->lineEditNumberOfPoints->setInputRange(ModbusLimits::bulkLengthRange());
         break;
         default:
         break;
@@ -54,5 +54,9 @@ void DialogSetupPresetData::accept()
     _params.SlaveAddress = ui->lineEditSlaveDevice->value<int>();
     _params.PointAddress = ui->lineEditAddress->value<int>();
     _params.Length = ui->lineEditNumberOfPoints->value<int>();
+
+    // a block larger than one request must still fit the address space
+    const int addr = _params.ZeroBasedAddress ? _params.PointAddress : _params.PointAddress - 1;
+    _params.Length = qMin(_params.Length, ModbusLimits::addressRange(true).to() - addr + 1);
     QFixedSizeDialog::accept();
 }
@@ -0,0 +1,403 @@
+#include <QColor>
+#include <QFileDialog>
+#include <QMessageBox>
+#include "formatutils.h"
+#include "dialogtagview.h"
+#include "ui_dialogtagview.h"
+
+///
+/// \brief TagViewModel::TagViewModel
+/// \param parent
+///
+TagViewModel::TagViewModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+///
+/// \brief TagViewModel::rowCount
+/// \return
+///
+int TagViewModel::rowCount(const QModelIndex&) const
+{
+    return _tags.size();
+}
+
+///
+/// \brief TagViewModel::columnCount
+/// \return
+///
+int TagViewModel::columnCount(const QModelIndex&) const
+{
+    return 5;
+}
+
+///
+/// \brief TagViewModel::data
+/// \param index
+/// \param role
+/// \return
+///
+QVariant TagViewModel::data(const QModelIndex& index, int role) const
+{
+    if(!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+
+    const auto& tag = _tags.at(index.row());
+    switch(role)
+    {
+        case Qt::DisplayRole:
+            switch(index.column())
+            {
+                case 0: return tag.Name;
+                case 1: return int(tag.DeviceId);
+                case 2: return formatAddress(tag.Type, tag.Address, false);
+                case 3: return TagDatabase::dataTypeName(tag.DataType);
+                case 4: return _values.at(index.row());
+            }
+        break;
+
+        case Qt::ForegroundRole:
+            if(index.column() == 4 && !_valid.at(index.row()))
+                return QColor(Qt::red);
+        break;
+    }
+
+    return QVariant();
+}
+
+///
+/// \brief TagViewModel::headerData
+/// \param section
+/// \param orientation
+/// \param role
+/// \return
+///
+QVariant TagViewModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+
+    switch(section)
+    {
+        case 0: return tr("Name");
+        case 1: return tr("Device");
+        case 2: return tr("Address");
+        case 3: return tr("Data Type");
+        case 4: return tr("Value");
+    }
+
+    return QVariant();
+}
+
+///
+/// \brief TagViewModel::reset
+/// \param db
+///
+void TagViewModel::reset(const TagDatabase& db)
+{
+    beginResetModel();
+    _tags = db.tags();
+    _values = QVector<QString>(_tags.size());
+    _valid = QVector<bool>(_tags.size(), true);
+    endResetModel();
+}
+
+///
+/// \brief TagViewModel::setValues
+/// \param req
+/// \param data
+///
+void TagViewModel::setValues(const ReadPlanRequest& req, const QModbusDataUnit& data)
+{
+    const auto values = data.values();
+    for(int i : req.Tags)
+    {
+        const auto& tag = _tags.at(i);
+        const int offset = tag.startAddress() - req.StartAddress;
+        const bool valid = offset >= 0 && offset + tag.length() <= values.size();
+
+        _values[i] = valid ? tag.format(tag.decode(values.constData() + offset)) : QString();
+        _valid[i] = valid;
+    }
+    updateValues();
+}
+
+///
+/// \brief TagViewModel::setError
+/// \param req
+/// \param error
+///
+void TagViewModel::setError(const ReadPlanRequest& req, const QString& error)
+{
+    for(int i : req.Tags)
+    {
+        _values[i] = error;
+        _valid[i] = false;
+    }
+    updateValues();
+}
+
+///
+/// \brief TagViewModel::updateValues
+///
+void TagViewModel::updateValues()
+{
+    // the tags of a request are scattered over the rows, the view repaints only the visible ones
+    if(rowCount() > 0)
+        emit dataChanged(index(0, 4), index(rowCount() - 1, 4), QVector<int>() << Qt::DisplayRole << Qt::ForegroundRole);
+}
+
+///
+/// \brief DialogTagView::DialogTagView
+/// \param client
+/// \param parent
+///
+DialogTagView::DialogTagView(ModbusClient& client, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::DialogTagView)
+    ,_modbusClient(client)
+    ,_model(new TagViewModel(this))
+    ,_outstanding(0)
+{
+    ui->setupUi(this);
+    setWindowFlags(Qt::Dialog |
+                   Qt::WindowCloseButtonHint |
+                   Qt::WindowMaximizeButtonHint);
+
+    ui->tableView->setModel(_model);
+    ui->spinBoxMaxGap->setValue(ReadPlanParams().MaxGap);
+
+    connect(&_timer, &QTimer::timeout, this, &DialogTagView::on_timeout);
+    connect(&_modbusClient, &ModbusClient::modbusRequest, this, &DialogTagView::on_modbusRequest);
+    connect(&_modbusClient, &ModbusClient::modbusReply, this, &DialogTagView::on_modbusReply);
+    connect(&_modbusClient, &ModbusClient::modbusError, this, &DialogTagView::on_modbusError);
+    connect(&_modbusClient, &ModbusClient::modbusDisconnected, this, &DialogTagView::on_modbusDisconnected);
+
+    compilePlan();
+    updateControls();
+}
+
+///
+/// \brief DialogTagView::~DialogTagView
+///
+DialogTagView::~DialogTagView()
+{
+    stop();
+    delete ui;
+}
+
+///
+/// \brief DialogTagView::on_pushButtonOpen_clicked
+///
+void DialogTagView::on_pushButtonOpen_clicked()
+{
+    const auto filename = QFileDialog::getOpenFileName(this, QString(), QString(), tr("Tag databases (*.json);;All files (*)"));
+    if(filename.isEmpty())
+        return;
+
+    TagDatabase db;
+    if(!db.load(filename))
+    {
+        QMessageBox::warning(this, windowTitle(), db.errorString());
+        return;
+    }
+
+    stop();
+    _db = db;
+    compilePlan();
+}
+
+///
+/// \brief DialogTagView::on_pushButtonImport_clicked
+///
+void DialogTagView::on_pushButtonImport_clicked()
+{
+    const auto filename = QFileDialog::getOpenFileName(this, QString(), QString(), tr("CSV files (*.csv *.txt);;All files (*)"));
+    if(filename.isEmpty())
+        return;
+
+    // imported tags are added to the ones already loaded
+    auto db = _db;
+    if(!db.importCsv(filename))
+    {
+        QMessageBox::warning(this, windowTitle(), db.errorString());
+        return;
+    }
+
+    stop();
+    _db = db;
+    compilePlan();
+}
+
+///
+/// \brief DialogTagView::on_pushButtonSave_clicked
+///
+void DialogTagView::on_pushButtonSave_clicked()
+{
+    const auto filename = QFileDialog::getSaveFileName(this, QString(), QString(), tr("Tag databases (*.json)"));
+    if(filename.isEmpty())
+        return;
+
+    if(!_db.save(filename))
+        QMessageBox::warning(this, windowTitle(), _db.errorString());
+}
+
+///
+/// \brief DialogTagView::on_pushButtonStart_clicked
+///
+void DialogTagView::on_pushButtonStart_clicked()
+{
+    if(_timer.isActive())
+    {
+        stop();
+    }
+    else if(!_plan.requests().isEmpty())
+    {
+        _timer.start(ui->spinBoxScanRate->value());
+        on_timeout();
+    }
+
+    updateControls();
+}
+
+///
+/// \brief DialogTagView::on_spinBoxMaxGap_valueChanged
+///
+void DialogTagView::on_spinBoxMaxGap_valueChanged(int)
+{
+    // requests already sent still match the old plan, so a running scan restarts
+    const bool running = _timer.isActive();
+    stop();
+    compilePlan();
+
+    if(running)
+        on_pushButtonStart_clicked();
+}
+
+///
+/// \brief DialogTagView::on_timeout
+///
+void DialogTagView::on_timeout()
+{
+    // the next scan waits for the previous one to complete
+    if(_outstanding > 0)
+        return;
+
+    for(auto&& req : _plan.requests())
+    {
+        if(_modbusClient.sendReadRequest(req.Type, req.StartAddress, req.Count, req.DeviceId, RequestId))
+            _outstanding++;
+    }
+}
+
+///
+/// \brief DialogTagView::on_modbusRequest
+/// \param requestId
+/// \param deviceId
+/// \param transactionId
+/// \param request
+///
+void DialogTagView::on_modbusRequest(int requestId, int deviceId, int transactionId, const QModbusRequest& request)
+{
+    Q_UNUSED(deviceId);
+    Q_UNUSED(request);
+
+    if(requestId == RequestId)
+        _transactions.insert(transactionId);
+}
+
+///
+/// \brief DialogTagView::on_modbusReply
+/// \param reply
+///
+void DialogTagView::on_modbusReply(QModbusReply* reply)
+{
+    if(!reply || reply->property("RequestId").toInt() != RequestId)
+        return;
+
+    // a read still in flight when the scan stopped belongs to no scan anymore
+    if(!_transactions.remove(reply->property("TransactionId").toInt()))
+        return;
+
+    _outstanding = qMax(0, _outstanding - 1);
+
+    const auto data = reply->property("RequestData").value<QModbusDataUnit>();
+    const int idx = _plan.find(reply->serverAddress(), data.registerType(), data.startAddress(), data.valueCount());
+    if(idx < 0)
+        return;
+
+    const auto& req = _plan.requests().at(idx);
+    if(reply->error() == QModbusDevice::NoError)
+        _model->setValues(req, reply->result());
+    else
+        _model->setError(req, reply->errorString());
+}
+
+///
+/// \brief DialogTagView::on_modbusError
+/// \param error
+/// \param requestId
+///
+void DialogTagView::on_modbusError(const QString& error, int requestId)
+{
+    Q_UNUSED(error);
+
+    // a request skipped by the client never gets a reply, and only requests of the
+    // current scan can still be skipped since stop() cancels the queued ones
+    if(requestId == RequestId)
+        _outstanding = qMax(0, _outstanding - 1);
+}
+
+///
+/// \brief DialogTagView::on_modbusDisconnected
+///
+void DialogTagView::on_modbusDisconnected()
+{
+    stop();
+    updateControls();
+}
+
+///
+/// \brief DialogTagView::compilePlan
+///
+void DialogTagView::compilePlan()
+{
+    ReadPlanParams params;
+    params.MaxGap = ui->spinBoxMaxGap->value();
+    params.MaxBitsGap = params.MaxGap * 16;
+
+    _plan = ReadPlan::compile(_db, params);
+    _model->reset(_db);
+
+    ui->labelPlan->setText(tr("%1 tags in %2 requests, %3 points read, %4 of them gaps")
+                           .arg(_plan.tagCount())
+                           .arg(_plan.requests().size())
+                           .arg(_plan.pointCount())
+                           .arg(_plan.gapCount()));
+    updateControls();
+}
+
+///
+/// \brief DialogTagView::stop
+///
+void DialogTagView::stop()
+{
+    _timer.stop();
+    _modbusClient.cancelRequests(RequestId);
+
+    // replies to the reads still in flight are not counted against the next scan
+    _transactions.clear();
+    _outstanding = 0;
+}
+
+///
+/// \brief DialogTagView::updateControls
+///
+void DialogTagView::updateControls()
+{
+    const bool running = _timer.isActive();
+    ui->pushButtonStart->setText(running ? tr("Stop") : tr("Start"));
+    ui->pushButtonStart->setEnabled(running || !_plan.requests().isEmpty());
+    ui->spinBoxScanRate->setEnabled(!running);
+}
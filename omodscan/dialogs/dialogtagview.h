@@ -0,0 +1,87 @@
+#ifndef DIALOGTAGVIEW_H
+#define DIALOGTAGVIEW_H
+
+#include <QSet>
+#include <QTimer>
+#include <QDialog>
+#include <QAbstractTableModel>
+#include "modbusclient.h"
+#include "tagdatabase.h"
+#include "readplan.h"
+
+namespace Ui {
+class DialogTagView;
+}
+
+///
+/// \brief The TagViewModel class shows the tags of a database with their last values
+///
+class TagViewModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit TagViewModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+    void reset(const TagDatabase& db);
+    void setValues(const ReadPlanRequest& req, const QModbusDataUnit& data);
+    void setError(const ReadPlanRequest& req, const QString& error);
+
+private:
+    void updateValues();
+
+private:
+    QVector<ModbusTag> _tags;
+    QVector<QString> _values;
+    QVector<bool> _valid;
+};
+
+///
+/// \brief The DialogTagView class polls the tags of a database through a compiled read plan
+///
+class DialogTagView : public QDialog
+{
+    Q_OBJECT
+
+public:
+    static const int RequestId = -5;
+
+    explicit DialogTagView(ModbusClient& client, QWidget *parent = nullptr);
+    ~DialogTagView();
+
+private slots:
+    void on_pushButtonOpen_clicked();
+    void on_pushButtonImport_clicked();
+    void on_pushButtonSave_clicked();
+    void on_pushButtonStart_clicked();
+    void on_spinBoxMaxGap_valueChanged(int value);
+    void on_timeout();
+    void on_modbusRequest(int requestId, int deviceId, int transactionId, const QModbusRequest& request);
+    void on_modbusReply(QModbusReply* reply);
+    void on_modbusError(const QString& error, int requestId);
+    void on_modbusDisconnected();
+
+private:
+    void compilePlan();
+    void stop();
+    void updateControls();
+
+private:
+    Ui::DialogTagView *ui;
+
+private:
+    ModbusClient& _modbusClient;
+    TagDatabase _db;
+    ReadPlan _plan;
+    TagViewModel* _model;
+    QTimer _timer;
+    int _outstanding;
+    QSet<int> _transactions;
+};
+
+#endif // DIALOGTAGVIEW_H
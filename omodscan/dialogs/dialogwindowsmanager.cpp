@@ -1,5 +1,4 @@
 #include <QAction>
-#include <QAbstractEventDispatcher>
 #include "dialogwindowsmanager.h"
 #include "ui_dialogwindowsmanager.h"
 
@@ -35,13 +34,8 @@ DialogWindowsManager::DialogWindowsManager(const QList<QAction*>& actions, QActi
 
     }
 
-    connect(QAbstractEventDispatcher::instance(), &QAbstractEventDispatcher::awake, this, [this]
-    {
-        const auto item = ui->listWidget->currentItem();
-        ui->pushButtonActivate->setEnabled(item != nullptr);
-        ui->pushButtonClose->setEnabled(item != nullptr);
-        ui->pushButtonSave->setEnabled(item != nullptr && _saveAction != nullptr);
-    });
+    connect(ui->listWidget, &QListWidget::currentItemChanged, this, &DialogWindowsManager::updateButtons);
+    updateButtons();
 }
 
 ///
@@ -64,6 +58,17 @@ void DialogWindowsManager::activateWindow(QListWidgetItem *item)
     if(action) action->trigger();
 }
 
+///
+/// \brief DialogWindowsManager::updateButtons
+///
+void DialogWindowsManager::updateButtons()
+{
+    const auto item = ui->listWidget->currentItem();
+    ui->pushButtonActivate->setEnabled(item != nullptr);
+    ui->pushButtonClose->setEnabled(item != nullptr);
+    ui->pushButtonSave->setEnabled(item != nullptr && _saveAction != nullptr);
+}
+
 ///
 /// \brief DialogWindowsManager::on_listWidget_itemDoubleClicked
 ///
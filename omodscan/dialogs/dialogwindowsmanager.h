@@ -28,6 +28,7 @@ private slots:
 
 private:
     void activateWindow(QListWidgetItem *item);
+    void updateButtons();
 
 private:
     Ui::DialogWindowsManager *ui;
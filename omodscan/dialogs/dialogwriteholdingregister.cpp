@@ -125,7 +125,7 @@ DialogWriteHoldingRegister::~DialogWriteHoldingRegister()
 void DialogWriteHoldingRegister::accept()
 {
     _writeParams.Address = ui->lineEditAddress->value<int>();
-    _writeParams.Value = ui->lineEditValue->value<QVariant>();
+    _writeParams.Value = ModbusValue::fromVariant(ui->lineEditValue->value<QVariant>());
     _writeParams.Node = ui->lineEditNode->value<int>();
 
     QFixedSizeDialog::accept();
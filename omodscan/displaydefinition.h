@@ -3,6 +3,7 @@
 
 #include <QSettings>
 #include <QModbusDataUnit>
+#include "enums.h"
 #include "modbuslimits.h"
 
 ///
@@ -17,6 +18,9 @@ struct DisplayDefinition
     quint16 Length = 50;
     quint16 LogViewLimit = 30;
     bool ZeroBasedAddress = false;
+    quint16 RefreshRate = 100;
+    PollingPolicy HiddenPolicy = PollingPolicy::FullRate;
+    quint32 HiddenScanRate = 5000;
 
     void normalize()
     {
@@ -26,6 +30,9 @@ struct DisplayDefinition
         PointType = qBound(QModbusDataUnit::DiscreteInputs, PointType, QModbusDataUnit::HoldingRegisters);
         Length = qBound<quint16>(ModbusLimits::lengthRange().from(), Length, ModbusLimits::lengthRange().to());
         LogViewLimit = qBound<quint16>(4, LogViewLimit, 1000);
+        RefreshRate = qBound<quint16>(33, RefreshRate, 1000);
+        HiddenPolicy = qBound(PollingPolicy::FullRate, HiddenPolicy, PollingPolicy::Pause);
+        HiddenScanRate = qBound(20U, HiddenScanRate, 3600000U);
     }
 };
 Q_DECLARE_METATYPE(DisplayDefinition)
@@ -39,6 +46,9 @@ inline QSettings& operator <<(QSettings& out, const DisplayDefinition& dd)
     out.setValue("DisplayDefinition/Length",            dd.Length);
     out.setValue("DisplayDefinition/LogViewLimit",      dd.LogViewLimit);
     out.setValue("DisplayDefinition/ZeroBasedAddress",  dd.ZeroBasedAddress);
+    out.setValue("DisplayDefinition/RefreshRate",       dd.RefreshRate);
+    out.setValue("DisplayDefinition/HiddenPolicy",      (uint)dd.HiddenPolicy);
+    out.setValue("DisplayDefinition/HiddenScanRate",    dd.HiddenScanRate);
 
     return out;
 }
@@ -58,6 +68,9 @@ inline QSettings& operator >>(QSettings& in, DisplayDefinition& dd)
     dd.Length = in.value("DisplayDefinition/Length", 50).toUInt();
     dd.LogViewLimit = in.value("DisplayDefinition/LogViewLimit", 30).toUInt();
     dd.ZeroBasedAddress = in.value("DisplayDefinition/ZeroBasedAddress").toBool();
+    dd.RefreshRate = in.value("DisplayDefinition/RefreshRate", 100).toUInt();
+    dd.HiddenPolicy = (PollingPolicy)in.value("DisplayDefinition/HiddenPolicy").toUInt();
+    dd.HiddenScanRate = in.value("DisplayDefinition/HiddenScanRate", 5000).toUInt();
 
     dd.normalize();
     return in;
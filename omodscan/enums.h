@@ -193,9 +193,28 @@ enum class SimulationMode
     Random,
     Increment,
     Decrement,
-    Toggle
+    Toggle,
+    Sine,
+    Triangle,
+    Square,
+    Ramp,
+    Noise,
+    Profile,
+    Expression
 };
 Q_DECLARE_METATYPE(SimulationMode);
 
+///
+/// \brief The PollingPolicy enum
+///
+enum class PollingPolicy
+{
+    FullRate = 0,
+    ReducedRate,
+    DataOnly,
+    Pause
+};
+Q_DECLARE_METATYPE(PollingPolicy);
+
 
 #endif // ENUMS_H
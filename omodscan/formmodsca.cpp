@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <QPainter>
 #include <QPalette>
 #include <QDateTime>
@@ -10,7 +11,7 @@
 #include "formmodsca.h"
 #include "ui_formmodsca.h"
 
-QVersionNumber FormModSca::VERSION = QVersionNumber(1, 5);
+QVersionNumber FormModSca::VERSION = QVersionNumber(1, 10);
 
 ///
 /// \brief FormModSca::FormModSca
@@ -25,6 +26,11 @@ FormModSca::FormModSca(int id, ModbusClient& client, DataSimulator* simulator, M
     ,_formId(id)
     ,_validSlaveResponses(0)
     ,_noSlaveResponsesCounter(0)
+    ,_hidden(false)
+    ,_scanRate(1000)
+    ,_hiddenScanRate(5000)
+    ,_hiddenPolicy(PollingPolicy::FullRate)
+    ,_hasLatchedStatus(false)
     ,_modbusClient(client)
     ,_dataSimulator(simulator)
     ,_parent(parent)
@@ -36,6 +42,7 @@ FormModSca::FormModSca(int id, ModbusClient& client, DataSimulator* simulator, M
     setWindowTitle(QString("ModSca%1").arg(_formId));
 
     _timer.setInterval(1000);
+    _refreshTimer.setInterval(100);
 
     ui->lineEditAddress->setPaddingZeroes(true);
     ui->lineEditAddress->setInputRange(ModbusLimits::addressRange(true));
@@ -61,10 +68,13 @@ FormModSca::FormModSca(int id, ModbusClient& client, DataSimulator* simulator, M
     connect(&_modbusClient, &ModbusClient::modbusConnected, this, &FormModSca::on_modbusConnected);
     connect(&_modbusClient, &ModbusClient::modbusDisconnected, this, &FormModSca::on_modbusDisconnected);
     connect(&_timer, &QTimer::timeout, this, &FormModSca::on_timeout);
+    connect(&_refreshTimer, &QTimer::timeout, this, &FormModSca::on_refreshTimeout);
 
     connect(_dataSimulator, &DataSimulator::simulationStarted, this, &FormModSca::on_simulationStarted);
     connect(_dataSimulator, &DataSimulator::simulationStopped, this, &FormModSca::on_simulationStopped);
     connect(_dataSimulator, &DataSimulator::dataSimulated, this, &FormModSca::on_dataSimulated);
+
+    _refreshTimer.start();
 }
 
 ///
@@ -89,6 +99,44 @@ void FormModSca::changeEvent(QEvent* event)
     QWidget::changeEvent(event);
 }
 
+///
+/// \brief FormModSca::showEvent
+/// \param event
+///
+void FormModSca::showEvent(QShowEvent* event)
+{
+    // the MDI subwindow exists only once the form is shown, watch it and the main window for minimizing
+    if(parentWidget()) parentWidget()->installEventFilter(this);
+    if(window() != this) window()->installEventFilter(this);
+
+    QWidget::showEvent(event);
+    updateVisibility();
+}
+
+///
+/// \brief FormModSca::hideEvent
+/// \param event
+///
+void FormModSca::hideEvent(QHideEvent* event)
+{
+    QWidget::hideEvent(event);
+    updateVisibility();
+}
+
+///
+/// \brief FormModSca::eventFilter
+/// \param obj
+/// \param event
+/// \return
+///
+bool FormModSca::eventFilter(QObject* obj, QEvent* event)
+{
+    if(event->type() == QEvent::WindowStateChange)
+        updateVisibility();
+
+    return QWidget::eventFilter(obj, event);
+}
+
 ///
 /// \brief FormModSca::filename
 /// \return
@@ -123,13 +171,16 @@ QVector<quint16> FormModSca::data() const
 DisplayDefinition FormModSca::displayDefinition() const
 {
     DisplayDefinition dd;
-    dd.ScanRate = _timer.interval();
+    dd.ScanRate = _scanRate;
     dd.DeviceId = ui->lineEditDeviceId->value<int>();
     dd.PointAddress = ui->lineEditAddress->value<int>();
     dd.PointType = ui->comboBoxModbusPointType->currentPointType();
     dd.Length = ui->lineEditLength->value<int>();
     dd.LogViewLimit = ui->outputWidget->logViewLimit();
     dd.ZeroBasedAddress = ui->lineEditAddress->range<int>().from() == 0;
+    dd.RefreshRate = _refreshTimer.interval();
+    dd.HiddenPolicy = _hiddenPolicy;
+    dd.HiddenScanRate = _hiddenScanRate;
 
     return dd;
 }
@@ -140,7 +191,11 @@ DisplayDefinition FormModSca::displayDefinition() const
 ///
 void FormModSca::setDisplayDefinition(const DisplayDefinition& dd)
 {
-    _timer.setInterval(dd.ScanRate);
+    _scanRate = dd.ScanRate;
+    _hiddenScanRate = dd.HiddenScanRate;
+    _hiddenPolicy = dd.HiddenPolicy;
+    _timer.setInterval(pollingInterval());
+    _refreshTimer.setInterval(dd.RefreshRate);
 
     ui->lineEditDeviceId->blockSignals(true);
     ui->lineEditDeviceId->setValue(dd.DeviceId);
@@ -168,6 +223,8 @@ void FormModSca::setDisplayDefinition(const DisplayDefinition& dd)
     const auto protocol = _modbusClient.connectionType() == ConnectionType::Serial ? ModbusMessage::Rtu : ModbusMessage::Tcp;
     ui->outputWidget->setup(dd, protocol, _dataSimulator->simulationMap(dd.DeviceId));
 
+    // data and status latched for the previous definition no longer apply
+    discardLatched();
     beginUpdate();
 }
 
@@ -187,6 +244,7 @@ DisplayMode FormModSca::displayMode() const
 void FormModSca::setDisplayMode(DisplayMode mode)
 {
     ui->outputWidget->setDisplayMode(mode);
+    emit displayModeChanged(mode);
 }
 
 ///
@@ -214,6 +272,7 @@ bool FormModSca::displayHexAddresses() const
 void FormModSca::setDisplayHexAddresses(bool on)
 {
     ui->outputWidget->setDisplayHexAddresses(on);
+    emit displayHexAddressesChanged(on);
 }
 
 ///
@@ -223,6 +282,7 @@ void FormModSca::setDisplayHexAddresses(bool on)
 void FormModSca::setDataDisplayMode(DataDisplayMode mode)
 {
     ui->outputWidget->setDataDisplayMode(mode);
+    emit dataDisplayModeChanged(mode);
 }
 
 ///
@@ -259,6 +319,7 @@ CaptureMode FormModSca::captureMode() const
 void FormModSca::startTextCapture(const QString& file)
 {
     ui->outputWidget->startTextCapture(file);
+    emit captureModeChanged(captureMode());
 }
 
 ///
@@ -267,6 +328,7 @@ void FormModSca::startTextCapture(const QString& file)
 void FormModSca::stopTextCapture()
 {
    ui->outputWidget->stopTextCapture();
+   emit captureModeChanged(captureMode());
 }
 
 ///
@@ -506,7 +568,10 @@ void FormModSca::on_timeout()
             _noSlaveResponsesCounter++;
             if(_noSlaveResponsesCounter > _modbusClient.numberOfRetries())
             {
-                ui->outputWidget->setStatus(tr("No Responses from Slave Device"));
+                if(_modbusClient.circuitState(dd.DeviceId) == CircuitState::Open)
+                    latchStatus(tr("No Responses from Slave Device, Polling Suspended"));
+                else
+                    latchStatus(tr("No Responses from Slave Device"));
             }
         }
 
@@ -522,6 +587,24 @@ void FormModSca::beginUpdate()
     if(_modbusClient.state() != QModbusDevice::ConnectedState)
         return;
 
+    if(_hidden)
+    {
+        // a hidden form polls on its own timer only, not right after every write
+        switch(_hiddenPolicy)
+        {
+            case PollingPolicy::Pause:
+            return;
+
+            case PollingPolicy::ReducedRate:
+            case PollingPolicy::DataOnly:
+                if(!_timer.isActive()) _timer.start();
+            return;
+
+            default:
+            break;
+        }
+    }
+
     const auto dd = displayDefinition();
     const auto addr = dd.PointAddress - (dd.ZeroBasedAddress ?  0 : 1);
     if(addr + dd.Length <= ModbusLimits::addressRange(dd.ZeroBasedAddress).to())
@@ -532,6 +615,97 @@ void FormModSca::beginUpdate()
     _timer.start();
 }
 
+///
+/// \brief FormModSca::isHiddenWindow
+/// \return
+///
+bool FormModSca::isHiddenWindow() const
+{
+    const auto wnd = parentWidget();
+    return !isVisible() || window()->isMinimized() || (wnd && wnd->isMinimized());
+}
+
+///
+/// \brief FormModSca::pollingInterval
+/// \return
+///
+quint32 FormModSca::pollingInterval() const
+{
+    if(_hidden && _hiddenPolicy == PollingPolicy::ReducedRate)
+        return qMax(_scanRate, _hiddenScanRate);
+
+    return _scanRate;
+}
+
+///
+/// \brief FormModSca::updateVisibility
+///
+void FormModSca::updateVisibility()
+{
+    const bool hidden = isHiddenWindow();
+    if(hidden == _hidden)
+        return;
+
+    _hidden = hidden;
+    _timer.setInterval(pollingInterval());
+
+    if(_hidden)
+    {
+        if(_hiddenPolicy == PollingPolicy::Pause)
+            _timer.stop();
+    }
+    else if(!_timer.isActive())
+    {
+        beginUpdate();
+    }
+}
+
+///
+/// \brief FormModSca::latchStatus
+/// \param status
+///
+void FormModSca::latchStatus(const QString& status)
+{
+    _latchedStatus = status;
+    _hasLatchedStatus = true;
+}
+
+///
+/// \brief FormModSca::discardLatched
+///
+void FormModSca::discardLatched()
+{
+    _latchedData = QModbusDataUnit();
+    _latchedStatus.clear();
+    _hasLatchedStatus = false;
+}
+
+///
+/// \brief FormModSca::on_refreshTimeout
+///
+void FormModSca::on_refreshTimeout()
+{
+    if(_hidden && _hiddenPolicy == PollingPolicy::DataOnly)
+    {
+        ui->statisticWidget->refresh();
+        return;
+    }
+
+    if(_latchedData.isValid())
+    {
+        ui->outputWidget->updateData(_latchedData);
+        _latchedData = QModbusDataUnit();
+    }
+
+    if(_hasLatchedStatus)
+    {
+        ui->outputWidget->setStatus(_latchedStatus);
+        _hasLatchedStatus = false;
+    }
+
+    ui->statisticWidget->refresh();
+}
+
 ///
 /// \brief FormModSca::isValidReply
 /// \param reply
@@ -646,8 +820,21 @@ void FormModSca::on_modbusReply(QModbusReply* reply)
         case QModbusRequest::ReadHoldingRegisters:
         break;
 
+        // file record and FIFO requests leave the registers as they are, no refresh needed
+        case QModbusRequest::ReadFileRecord:
+        case QModbusRequest::WriteFileRecord:
+        case QModbusRequest::ReadFifoQueue:
+        return;
+
         default:
-            if(!hasError) beginUpdate();
+        {
+            // the tools (negative ids) write in bursts, the regular polls pick their values up
+            auto requestIds = reply->property("RequestIds").value<QList<int>>();
+            if(requestIds.isEmpty()) requestIds.push_back(reply->property("RequestId").toInt());
+
+            const bool toolReply = std::all_of(requestIds.cbegin(), requestIds.cend(), [](int id) { return id < 0; });
+            if(!hasError && !toolReply) beginUpdate();
+        }
         return;
     }
 
@@ -658,12 +845,13 @@ void FormModSca::on_modbusReply(QModbusReply* reply)
     {
         if(!isValidReply(reply))
         {
-            ui->outputWidget->setStatus(tr("Received Invalid Response MODBUS Query"));
+            latchStatus(tr("Received Invalid Response MODBUS Query"));
         }
         else
         {
-            ui->outputWidget->updateData(reply->result());
-            ui->outputWidget->setStatus(QString());
+            _latchedData = reply->result();
+            _dataSimulator->updateRegisters(reply->serverAddress(), _latchedData);
+            latchStatus(QString());
             ui->statisticWidget->increaseValidSlaveResponses();
         }
     }
@@ -671,11 +859,11 @@ void FormModSca::on_modbusReply(QModbusReply* reply)
     {
         const auto ex = ModbusException(response.exceptionCode());
         const auto errorString = QString("%1 (%2)").arg(ex, formatUInt8Value(DataDisplayMode::Hex, ex));
-        ui->outputWidget->setStatus(errorString);
+        latchStatus(errorString);
     }
     else
     {
-        ui->outputWidget->setStatus(reply->errorString());
+        latchStatus(reply->errorString());
     }
 
     _noSlaveResponsesCounter = 0;
@@ -700,6 +888,8 @@ void FormModSca::on_modbusConnected(const ConnectionDetails&)
 void FormModSca::on_modbusDisconnected(const ConnectionDetails&)
 {
     _timer.stop();
+    discardLatched();
+    ui->statisticWidget->refresh();
     ui->outputWidget->setStatus(tr("Device NOT CONNECTED!"));
 }
 
@@ -711,6 +901,7 @@ void FormModSca::on_lineEditAddress_valueChanged(const QVariant&)
     const quint8 deviceId = ui->lineEditDeviceId->value<int>();
     const auto protocol = _modbusClient.connectionType() == ConnectionType::Serial ? ModbusMessage::Rtu : ModbusMessage::Tcp;
     ui->outputWidget->setup(displayDefinition(), protocol, _dataSimulator->simulationMap(deviceId));
+    discardLatched();
     beginUpdate();
 }
 
@@ -722,6 +913,7 @@ void FormModSca::on_lineEditLength_valueChanged(const QVariant&)
     const quint8 deviceId = ui->lineEditDeviceId->value<int>();
     const auto protocol = _modbusClient.connectionType() == ConnectionType::Serial ? ModbusMessage::Rtu : ModbusMessage::Tcp;
     ui->outputWidget->setup(displayDefinition(), protocol, _dataSimulator->simulationMap(deviceId));
+    discardLatched();
     beginUpdate();
 }
 
@@ -733,6 +925,7 @@ void FormModSca::on_lineEditDeviceId_valueChanged(const QVariant&)
     const quint8 deviceId = ui->lineEditDeviceId->value<int>();
     const auto protocol = _modbusClient.connectionType() == ConnectionType::Serial ? ModbusMessage::Rtu : ModbusMessage::Tcp;
     ui->outputWidget->setup(displayDefinition(), protocol, _dataSimulator->simulationMap(deviceId));
+    discardLatched();
     beginUpdate();
 }
 
@@ -756,6 +949,7 @@ void FormModSca::on_comboBoxModbusPointType_pointTypeChanged(QModbusDataUnit::Re
     const quint8 deviceId = ui->lineEditDeviceId->value<int>();
     const auto protocol = _modbusClient.connectionType() == ConnectionType::Serial ? ModbusMessage::Rtu : ModbusMessage::Tcp;
     ui->outputWidget->setup(displayDefinition(), protocol, _dataSimulator->simulationMap(deviceId));
+    discardLatched();
     beginUpdate();
 }
 
@@ -784,7 +978,7 @@ void FormModSca::on_outputWidget_itemDoubleClicked(quint16 addr, const QVariant&
     {
         case QModbusDataUnit::Coils:
         {
-            ModbusWriteParams params = { node, addr, value, mode, byteOrder(), zeroBasedAddress };
+            ModbusWriteParams params = { node, addr, ModbusValue::fromVariant(value), mode, byteOrder(), zeroBasedAddress };
             DialogWriteCoilRegister dlg(params, simParams, _parent);
             switch(dlg.exec())
             {
@@ -802,7 +996,7 @@ void FormModSca::on_outputWidget_itemDoubleClicked(quint16 addr, const QVariant&
 
         case QModbusDataUnit::HoldingRegisters:
         {
-            ModbusWriteParams params = { node, addr, value, mode, byteOrder(), zeroBasedAddress };
+            ModbusWriteParams params = { node, addr, ModbusValue::fromVariant(value), mode, byteOrder(), zeroBasedAddress };
             if(mode == DataDisplayMode::Binary)
             {
                 DialogWriteHoldingRegisterBits dlg(params, _parent);
@@ -878,12 +1072,9 @@ void FormModSca::on_simulationStopped(QModbusDataUnit::RegisterType type, quint1
 
 ///
 /// \brief FormModSca::on_dataSimulated
-/// \param mode
-/// \param type
-/// \param addr
-/// \param value
+/// \param values
 ///
-void FormModSca::on_dataSimulated(DataDisplayMode mode, QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId, QVariant value)
+void FormModSca::on_dataSimulated(const SimulatedValues& values)
 {
     if(_modbusClient.state() != QModbusDevice::ConnectedState)
     {
@@ -891,15 +1082,14 @@ void FormModSca::on_dataSimulated(DataDisplayMode mode, QModbusDataUnit::Registe
     }
 
     const auto dd = displayDefinition();
-    if(dd.DeviceId != deviceId)
-    {
-        return;
-    }
-
     const auto pointAddr = dd.PointAddress - (dd.ZeroBasedAddress ? 0 : 1);
-    if(type == dd.PointType && addr >= pointAddr && addr <= pointAddr + dd.Length)
+
+    QVector<ModbusWriteParams> params;
+    for(auto&& v : values)
     {
-        const ModbusWriteParams params = { dd.DeviceId, addr, value, mode, byteOrder(), true };
-        _modbusClient.writeRegister(type, params, formId());
+        if(v.DeviceId == dd.DeviceId && v.Type == dd.PointType && v.Address >= pointAddr && v.Address <= pointAddr + dd.Length)
+            params.push_back({ dd.DeviceId, v.Address, v.Value, v.Mode, byteOrder(), true });
     }
+
+    _modbusClient.writeRegisters(dd.PointType, params, formId(), RequestPriority::Background);
 }
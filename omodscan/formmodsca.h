@@ -96,14 +96,22 @@ public slots:
 signals:
     void showed();
     void byteOrderChanged(ByteOrder);
+    void displayModeChanged(DisplayMode mode);
+    void dataDisplayModeChanged(DataDisplayMode mode);
+    void displayHexAddressesChanged(bool on);
+    void captureModeChanged(CaptureMode mode);
     void numberOfPollsChanged(uint value);
     void validSlaveResposesChanged(uint value);
 
 protected:
     void changeEvent(QEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+    bool eventFilter(QObject* obj, QEvent* event) override;
 
 private slots:
     void on_timeout();
+    void on_refreshTimeout();
     void on_modbusConnected(const ConnectionDetails& cd);
     void on_modbusDisconnected(const ConnectionDetails& cd);
     void on_modbusReply(QModbusReply* reply);
@@ -118,10 +126,15 @@ private slots:
     void on_statisticWidget_validSlaveResposesChanged(uint value);
     void on_simulationStarted(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId);
     void on_simulationStopped(QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId);
-    void on_dataSimulated(DataDisplayMode mode, QModbusDataUnit::RegisterType type, quint16 addr, quint8 deviceId, QVariant value);
+    void on_dataSimulated(const SimulatedValues& values);
 
 private:
     void beginUpdate();
+    void updateVisibility();
+    bool isHiddenWindow() const;
+    quint32 pollingInterval() const;
+    void latchStatus(const QString& status);
+    void discardLatched();
     bool isValidReply(const QModbusReply* reply) const;
 
     void logReply(const QModbusReply* reply);
@@ -132,7 +145,15 @@ private:
     int _formId;
     uint _validSlaveResponses;
     uint _noSlaveResponsesCounter;
+    bool _hidden;
+    quint32 _scanRate;
+    quint32 _hiddenScanRate;
+    PollingPolicy _hiddenPolicy;
     QTimer _timer;
+    QTimer _refreshTimer;
+    QModbusDataUnit _latchedData;
+    QString _latchedStatus;
+    bool _hasLatchedStatus;
     QString _filename;
     ModbusClient& _modbusClient;
     DataSimulator* _dataSimulator;
@@ -250,11 +271,31 @@ inline QDataStream& operator <<(QDataStream& out, const FormModSca* frm)
     out << dd.Length;
     out << dd.LogViewLimit;
     out << dd.ZeroBasedAddress;
+    out << dd.RefreshRate;
+    out << dd.HiddenPolicy;
+    out << dd.HiddenScanRate;
 
     out << frm->byteOrder();
-    out << frm->simulationMap();
+    const auto simulationMap = frm->simulationMap();
+    out << simulationMap;
     out << frm->descriptionMap();
 
+    QMap<QPair<QModbusDataUnit::RegisterType, quint16>, WaveformSimulationParams> waveformMap;
+    for(auto it = simulationMap.cbegin(); it != simulationMap.cend(); ++it)
+    {
+        if(it->isWaveform())
+            waveformMap[it.key()] = it->WaveformParams;
+    }
+    out << waveformMap;
+
+    QMap<QPair<QModbusDataUnit::RegisterType, quint16>, ExpressionSimulationParams> expressionMap;
+    for(auto it = simulationMap.cbegin(); it != simulationMap.cend(); ++it)
+    {
+        if(it->Mode == SimulationMode::Expression)
+            expressionMap[it.key()] = it->ExpressionParams;
+    }
+    out << expressionMap;
+
     return out;
 }
 
@@ -310,6 +351,15 @@ inline QDataStream& operator >>(QDataStream& in, FormModSca* frm)
     {
         in >> dd.ZeroBasedAddress;
     }
+    if(ver >= QVersionNumber(1, 6))
+    {
+        in >> dd.RefreshRate;
+    }
+    if(ver >= QVersionNumber(1, 7))
+    {
+        in >> dd.HiddenPolicy;
+        in >> dd.HiddenScanRate;
+    }
 
     ByteOrder byteOrder = ByteOrder::LittleEndian;
     ModbusSimulationMap simulationMap;
@@ -318,6 +368,12 @@ inline QDataStream& operator >>(QDataStream& in, FormModSca* frm)
         in >> byteOrder;
         in >> simulationMap;
     }
+    if(ver < QVersionNumber(1, 8))
+    {
+        // simulation intervals used to be stored in seconds
+        for(auto&& params : simulationMap)
+            params.Interval *= 1000;
+    }
 
     AddressDescriptionMap descriptionMap;
     if(ver >= QVersionNumber(1, 2))
@@ -325,6 +381,30 @@ inline QDataStream& operator >>(QDataStream& in, FormModSca* frm)
         in >> descriptionMap;
     }
 
+    if(ver >= QVersionNumber(1, 9))
+    {
+        QMap<QPair<QModbusDataUnit::RegisterType, quint16>, WaveformSimulationParams> waveformMap;
+        in >> waveformMap;
+
+        for(auto it = waveformMap.cbegin(); it != waveformMap.cend(); ++it)
+        {
+            if(simulationMap.contains(it.key()))
+                simulationMap[it.key()].WaveformParams = it.value();
+        }
+    }
+
+    if(ver >= QVersionNumber(1, 10))
+    {
+        QMap<QPair<QModbusDataUnit::RegisterType, quint16>, ExpressionSimulationParams> expressionMap;
+        in >> expressionMap;
+
+        for(auto it = expressionMap.cbegin(); it != expressionMap.cend(); ++it)
+        {
+            if(simulationMap.contains(it.key()))
+                simulationMap[it.key()].ExpressionParams = it.value();
+        }
+    }
+
     if(in.status() != QDataStream::Ok)
         return in;
 
@@ -10,12 +10,17 @@
 #include "dialogsetuppresetdata.h"
 #include "dialogforcemultiplecoils.h"
 #include "dialogforcemultipleregisters.h"
+#include "dialogbulkwrite.h"
 #include "dialogusermsg.h"
+#include "dialogfiletransfer.h"
+#include "dialogfiforeader.h"
+#include "dialogtagview.h"
 #include "dialogmsgparser.h"
 #include "dialogaddressscan.h"
 #include "dialogmodbusscanner.h"
 #include "dialogwindowsmanager.h"
 #include "dialogabout.h"
+#include "modbuslimits.h"
 #include "mainstatusbar.h"
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
@@ -58,10 +63,19 @@ MainWindow::MainWindow(QWidget *parent)
     _windowActionList = new WindowActionList(ui->menuWindow, ui->actionWindows);
     connect(_windowActionList, &WindowActionList::triggered, this, &MainWindow::windowActivate);
 
-    auto dispatcher = QAbstractEventDispatcher::instance();
-    connect(dispatcher, &QAbstractEventDispatcher::awake, this, &MainWindow::on_awake);
+    connect(ui->toolBarMain, &QToolBar::visibilityChanged, this, &MainWindow::updateActions);
+    connect(ui->toolBarDisplay, &QToolBar::visibilityChanged, this, &MainWindow::updateActions);
 
     connect(ui->mdiArea, &QMdiArea::subWindowActivated, this, &MainWindow::updateMenuWindow);
+    connect(ui->mdiArea, &QMdiArea::subWindowActivated, this, &MainWindow::updateActions);
+    connect(ui->mdiArea, &QMdiArea::subWindowActivated, this, [this](QMdiSubWindow* wnd)
+    {
+        const auto frm = wnd ? qobject_cast<FormModSca*>(wnd->widget()) : nullptr;
+        if(frm) _modbusClient.setActiveRequestId(frm->formId());
+    });
+    connect(&_modbusClient, &ModbusClient::modbusConnecting, this, &MainWindow::updateActions);
+    connect(&_modbusClient, &ModbusClient::modbusConnected, this, &MainWindow::updateActions);
+    connect(&_modbusClient, &ModbusClient::modbusDisconnected, this, &MainWindow::updateActions);
     connect(&_modbusClient, &ModbusClient::modbusError, this, &MainWindow::on_modbusError);
     connect(&_modbusClient, &ModbusClient::modbusConnectionError, this, &MainWindow::on_modbusConnectionError);
     connect(&_modbusClient, &ModbusClient::modbusConnected, this, &MainWindow::on_modbusConnected);
@@ -69,6 +83,7 @@ MainWindow::MainWindow(QWidget *parent)
 
     ui->actionNew->trigger();
     loadSettings();
+    updateActions();
 }
 
 ///
@@ -102,6 +117,8 @@ void MainWindow::setLanguage(const QString& lang)
         if(_qtTranslator.load(QString("%1/translations/qt_%2").arg(qApp->applicationDirPath(), lang)))
             qApp->installTranslator(&_qtTranslator);
     }
+
+    updateActions();
 }
 
 ///
@@ -155,9 +172,9 @@ bool MainWindow::eventFilter(QObject* obj, QEvent* e)
 }
 
 ///
-/// \brief MainWindow::on_awake
+/// \brief MainWindow::updateActions
 ///
-void MainWindow::on_awake()
+void MainWindow::updateActions()
 {
     auto frm = currentMdiChild();
     const auto state = _modbusClient.state();
@@ -194,7 +211,10 @@ void MainWindow::on_awake()
     ui->actionPresetRegs->setEnabled(state == QModbusDevice::ConnectedState);
     ui->actionMaskWrite->setEnabled(state == QModbusDevice::ConnectedState);
     ui->actionUserMsg->setEnabled(state == QModbusDevice::ConnectedState);
+    ui->actionFileTransfer->setEnabled(state == QModbusDevice::ConnectedState);
+    ui->actionFifoReader->setEnabled(state == QModbusDevice::ConnectedState);
     ui->actionAddressScan->setEnabled(state == QModbusDevice::ConnectedState);
+    ui->actionTagView->setEnabled(state == QModbusDevice::ConnectedState);
     ui->actionTextCapture->setEnabled(frm && frm->captureMode() == CaptureMode::Off);
     ui->actionCaptureOff->setEnabled(frm && frm->captureMode() == CaptureMode::TextCapture);
     ui->actionResetCtrs->setEnabled(frm != nullptr);
@@ -372,6 +392,8 @@ void MainWindow::on_actionPrintSetup_triggered()
 {
     DialogPrintSettings dlg(_selectedPrinter, this);
     dlg.exec();
+
+    updateActions();
 }
 
 ///
@@ -417,6 +439,7 @@ void MainWindow::on_actionEnable_triggered()
 {
     DialogAutoStart dlg(_fileAutoStart, this);
     _autoStart = dlg.exec() == QDialog::Accepted;
+    updateActions();
 }
 
 ///
@@ -425,6 +448,7 @@ void MainWindow::on_actionEnable_triggered()
 void MainWindow::on_actionDisable_triggered()
 {
     _autoStart = false;
+    updateActions();
 }
 
 ///
@@ -686,13 +710,21 @@ void MainWindow::on_actionForceCoils_triggered()
        dd.DeviceId == params.Node &&
        dd.PointAddress == params.Address)
     {
-        params.Value = QVariant::fromValue(frm->data());
+        params.Value = frm->data();
     }
 
     DialogForceMultipleCoils dlg(params, presetParams.Length, this);
     if(dlg.exec() == QDialog::Accepted)
     {
-        _modbusClient.writeRegister(QModbusDataUnit::Coils, params, 0);
+        if(presetParams.Length > ModbusLimits::writeBitsLengthRange().to() || dlg.verify())
+        {
+            DialogBulkWrite bulk(_modbusClient, QModbusDataUnit::Coils, params, dlg.verify(), this);
+            bulk.exec();
+        }
+        else
+        {
+            _modbusClient.writeRegister(QModbusDataUnit::Coils, params, 0);
+        }
     }
 }
 
@@ -723,13 +755,21 @@ void MainWindow::on_actionPresetRegs_triggered()
        dd.DeviceId == params.Node &&
        dd.PointAddress == params.Address)
     {
-        params.Value = QVariant::fromValue(frm->data());
+        params.Value = frm->data();
     }
 
     DialogForceMultipleRegisters dlg(params, presetParams.Length, this);
     if(dlg.exec() == QDialog::Accepted)
     {
-        _modbusClient.writeRegister(QModbusDataUnit::HoldingRegisters, params, 0);
+        if(presetParams.Length > ModbusLimits::writeLengthRange().to() || dlg.verify())
+        {
+            DialogBulkWrite bulk(_modbusClient, QModbusDataUnit::HoldingRegisters, params, dlg.verify(), this);
+            bulk.exec();
+        }
+        else
+        {
+            _modbusClient.writeRegister(QModbusDataUnit::HoldingRegisters, params, 0);
+        }
     }
 }
 
@@ -790,6 +830,56 @@ void MainWindow::on_actionUserMsg_triggered()
     dlg.exec();
 }
 
+///
+/// \brief MainWindow::on_actionFileTransfer_triggered
+///
+void MainWindow::on_actionFileTransfer_triggered()
+{
+    auto frm = currentMdiChild();
+    if(!frm) return;
+
+    DialogFileTransfer dlg(frm->displayDefinition().DeviceId, _modbusClient, this);
+    dlg.exec();
+}
+
+///
+/// \brief MainWindow::on_actionFifoReader_triggered
+///
+void MainWindow::on_actionFifoReader_triggered()
+{
+    // the reader owns a single request id, so one drain runs at a time
+    if(_fifoReader)
+    {
+        _fifoReader->raise();
+        _fifoReader->activateWindow();
+        return;
+    }
+
+    auto frm = currentMdiChild();
+    const auto dd = frm ? frm->displayDefinition() : DisplayDefinition();
+
+    _fifoReader = new DialogFifoReader(dd.DeviceId, dd.PointAddress, dd.ZeroBasedAddress, _modbusClient, this);
+    _fifoReader->setAttribute(Qt::WA_DeleteOnClose, true);
+    _fifoReader->show();
+}
+
+///
+/// \brief MainWindow::on_actionTagView_triggered
+///
+void MainWindow::on_actionTagView_triggered()
+{
+    if(_tagView)
+    {
+        _tagView->raise();
+        _tagView->activateWindow();
+        return;
+    }
+
+    _tagView = new DialogTagView(_modbusClient, this);
+    _tagView->setAttribute(Qt::WA_DeleteOnClose, true);
+    _tagView->show();
+}
+
 ///
 /// \brief MainWindow::on_actionMsgParser_triggered
 ///
@@ -869,6 +959,7 @@ void MainWindow::on_actionToolbar_triggered()
 void MainWindow::on_actionStatusBar_triggered()
 {
     ui->statusbar->setVisible(!ui->statusbar->isVisible());
+    updateActions();
 }
 
 ///
@@ -1041,6 +1132,8 @@ void MainWindow::openFile(const QString& filename)
                     QString(tr("Failed to open %1")).arg(filename);
 
         _recentFileActionList->removeRecentFile(filename);
+        updateActions();
+
         QMessageBox::warning(this, windowTitle(), message);
     }
 }
@@ -1052,6 +1145,7 @@ void MainWindow::openFile(const QString& filename)
 void MainWindow::addRecentFile(const QString& filename)
 {
     _recentFileActionList->addRecentFile(filename);
+    updateActions();
 }
 
 ///
@@ -1100,6 +1194,12 @@ FormModSca* MainWindow::createMdiChild(int id)
         updateIcons(order);
     });
 
+    connect(frm, &FormModSca::byteOrderChanged, this, &MainWindow::updateActions);
+    connect(frm, &FormModSca::displayModeChanged, this, &MainWindow::updateActions);
+    connect(frm, &FormModSca::dataDisplayModeChanged, this, &MainWindow::updateActions);
+    connect(frm, &FormModSca::displayHexAddressesChanged, this, &MainWindow::updateActions);
+    connect(frm, &FormModSca::captureModeChanged, this, &MainWindow::updateActions);
+
     connect(frm, &FormModSca::numberOfPollsChanged, this, [this](uint)
     {
         qobject_cast<MainStatusBar*>(statusBar())->updateNumberOfPolls();
@@ -3,6 +3,7 @@
 
 #include <QMainWindow>
 #include <QTranslator>
+#include <QPointer>
 #include "modbusclient.h"
 #include "formmodsca.h"
 #include "windowactionlist.h"
@@ -31,8 +32,6 @@ protected:
     bool eventFilter(QObject* obj, QEvent* e) override;
 
 private slots:
-    void on_awake();
-
     /* File menu slots */
     void on_actionNew_triggered();
     void on_actionOpen_triggered();
@@ -80,6 +79,9 @@ private slots:
     void on_actionPresetRegs_triggered();
     void on_actionMaskWrite_triggered();
     void on_actionUserMsg_triggered();
+    void on_actionFileTransfer_triggered();
+    void on_actionFifoReader_triggered();
+    void on_actionTagView_triggered();
     void on_actionMsgParser_triggered();
     void on_actionAddressScan_triggered();
     void on_actionTextCapture_triggered();
@@ -113,6 +115,7 @@ private slots:
     void on_modbusConnected(const ConnectionDetails& cd);
     void on_modbusDisconnected(const ConnectionDetails& cd);
 
+    void updateActions();
     void updateMenuWindow();
     void openFile(const QString& filename);
     void windowActivate(QMdiSubWindow* wnd);
@@ -156,5 +159,7 @@ private:
     RecentFileActionList* _recentFileActionList;
     QPrinter* _selectedPrinter;
     DataSimulator* _dataSimulator;
+    QPointer<QDialog> _fifoReader;
+    QPointer<QDialog> _tagView;
 };
 #endif // MAINWINDOW_H
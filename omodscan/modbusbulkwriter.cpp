@@ -0,0 +1,340 @@
+#include <climits>
+#include <QFile>
+#include <QTextStream>
+#include <QRegularExpression>
+#include "modbuslimits.h"
+#include "modbusbulkwriter.h"
+
+///
+/// \brief ModbusBulkWriter::ModbusBulkWriter
+/// \param client
+/// \param parent
+///
+ModbusBulkWriter::ModbusBulkWriter(ModbusClient& client, QObject* parent)
+    : QObject(parent)
+    ,_client(client)
+    ,_server(0)
+    ,_verify(false)
+    ,_inProgress(false)
+    ,_verifying(false)
+    ,_written(0)
+    ,_verified(0)
+    ,_failed(0)
+    ,_mismatched(0)
+    ,_replyErrors(0)
+{
+    connect(&_client, &ModbusClient::modbusReply, this, &ModbusBulkWriter::on_modbusReply);
+    connect(&_client, &ModbusClient::modbusError, this, &ModbusBulkWriter::on_modbusError);
+    connect(&_client, &ModbusClient::modbusDisconnected, this, &ModbusBulkWriter::on_modbusDisconnected);
+}
+
+///
+/// \brief ModbusBulkWriter::~ModbusBulkWriter
+///
+ModbusBulkWriter::~ModbusBulkWriter()
+{
+    cancel();
+}
+
+///
+/// \brief ModbusBulkWriter::start
+/// \param pointType
+/// \param params
+/// \param verify
+///
+void ModbusBulkWriter::start(QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params, bool verify)
+{
+    _server = params.Node;
+    _verify = verify;
+    _verifying = false;
+    _written = _verified = _failed = _mismatched = _replyErrors = 0;
+    _expected = createWriteDataUnit(pointType, params);
+    _writeDone = QBitArray(_expected.valueCount());
+    _verifyDone = QBitArray(_expected.valueCount());
+
+    _inProgress = true;
+    _timer.start();
+
+    if(_expected.valueCount() == 0)
+    {
+        finish();
+        return;
+    }
+
+    if(_client.state() != QModbusDevice::ConnectedState)
+    {
+        _failed = _expected.valueCount();
+        finish();
+        return;
+    }
+
+    // the client's write queue splits the block into maximal FC15/FC16 requests
+    // and keeps as many of them in flight as the connection allows
+    _client.writeRegister(pointType, params, RequestId);
+}
+
+///
+/// \brief ModbusBulkWriter::cancel
+///
+void ModbusBulkWriter::cancel()
+{
+    if(!_inProgress)
+        return;
+
+    _client.cancelRequests(RequestId);
+    _inProgress = false;
+    _verifying = false;
+}
+
+///
+/// \brief ModbusBulkWriter::throughput
+/// \return values per second of the current stage
+///
+double ModbusBulkWriter::throughput() const
+{
+    const auto elapsed = _timer.isValid() ? _timer.elapsed() : 0;
+    const int count = _verifying ? _verified : _written;
+    return elapsed > 0 ? count * 1000. / elapsed : 0.;
+}
+
+///
+/// \brief hasRequestId
+/// \param reply
+/// \param requestId
+/// \return true if the request of the reply was sent for the id, alone or merged with others
+///
+static bool hasRequestId(const QModbusReply* reply, int requestId)
+{
+    const auto requestIds = reply->property("RequestIds").value<QList<int>>();
+    if(requestIds.isEmpty())
+        return reply->property("RequestId").toInt() == requestId;
+
+    return requestIds.contains(requestId);
+}
+
+///
+/// \brief ModbusBulkWriter::on_modbusReply
+/// \param reply
+///
+void ModbusBulkWriter::on_modbusReply(QModbusReply* reply)
+{
+    if(!_inProgress || !reply || reply->serverAddress() != _server || !hasRequestId(reply, RequestId))
+        return;
+
+    // failed replies carry no PDU, the range comes from the request
+    const auto data = reply->property("RequestData").value<QModbusDataUnit>();
+    if(data.registerType() != _expected.registerType())
+        return;
+
+    // writes go out as raw requests, reads as common ones
+    if(!_verifying && reply->type() == QModbusReply::Raw)
+    {
+        // the client reports the error of a failed write right after its reply
+        if(reply->error() != QModbusDevice::NoError)
+            _replyErrors++;
+
+        processWriteReply(reply, data);
+    }
+    else if(_verifying && reply->type() == QModbusReply::Common)
+    {
+        processReadReply(reply, data);
+    }
+}
+
+///
+/// \brief ModbusBulkWriter::on_modbusError
+/// \param error
+/// \param requestId
+///
+void ModbusBulkWriter::on_modbusError(const QString& error, int requestId)
+{
+    Q_UNUSED(error);
+
+    if(!_inProgress || requestId != RequestId)
+        return;
+
+    if(_replyErrors > 0)
+    {
+        _replyErrors--;
+        return;
+    }
+
+    // the client dropped a request, the values it carried will never be confirmed
+    _client.cancelRequests(RequestId);
+
+    const auto& done = _verifying ? _verifyDone : _writeDone;
+    _failed += done.size() - done.count(true);
+    finish();
+}
+
+///
+/// \brief ModbusBulkWriter::on_modbusDisconnected
+///
+void ModbusBulkWriter::on_modbusDisconnected()
+{
+    if(!_inProgress)
+        return;
+
+    // whatever was still queued is gone with the connection
+    const auto& done = _verifying ? _verifyDone : _writeDone;
+    _failed += done.size() - done.count(true);
+    finish();
+}
+
+///
+/// \brief ModbusBulkWriter::markDone
+/// \param done
+/// \param startAddress
+/// \param count
+/// \return number of values of the block newly covered by the range
+///
+int ModbusBulkWriter::markDone(QBitArray& done, int startAddress, int count)
+{
+    const int from = qMax(startAddress, _expected.startAddress()) - _expected.startAddress();
+    const int to = qMin<int>(startAddress + count, _expected.startAddress() + _expected.valueCount()) - _expected.startAddress();
+
+    int marked = 0;
+    for(int i = from; i < to; i++)
+    {
+        if(!done.testBit(i))
+        {
+            done.setBit(i);
+            marked++;
+        }
+    }
+
+    return marked;
+}
+
+///
+/// \brief ModbusBulkWriter::processWriteReply
+/// \param reply
+/// \param data
+///
+void ModbusBulkWriter::processWriteReply(QModbusReply* reply, const QModbusDataUnit& data)
+{
+    // the write queue may have merged part of the block with other pending writes
+    // to the same device, only the addresses of the block count
+    const int marked = markDone(_writeDone, data.startAddress(), data.valueCount());
+    if(marked == 0)
+        return;
+
+    if(reply->error() != QModbusDevice::NoError)
+        _failed += marked;
+    else
+        _written += marked;
+
+    emit progress();
+
+    if(_writeDone.count(true) == _writeDone.size())
+    {
+        if(_verify && _failed == 0) startVerify();
+        else finish();
+    }
+}
+
+///
+/// \brief ModbusBulkWriter::processReadReply
+/// \param reply
+/// \param request
+///
+void ModbusBulkWriter::processReadReply(QModbusReply* reply, const QModbusDataUnit& request)
+{
+    const int marked = markDone(_verifyDone, request.startAddress(), request.valueCount());
+    if(marked == 0)
+        return;
+
+    if(reply->error() != QModbusDevice::NoError)
+    {
+        _failed += marked;
+    }
+    else
+    {
+        const auto result = reply->result();
+        const bool bits = _expected.registerType() == QModbusDataUnit::Coils;
+        for(uint i = 0; i < request.valueCount(); i++)
+        {
+            const int idx = request.startAddress() + i - _expected.startAddress();
+            const quint16 expected = _expected.value(idx);
+            const quint16 actual = i < result.valueCount() ? result.value(i) : ~expected;
+            if(bits ? (expected != 0) != (actual != 0) : expected != actual)
+                _mismatched++;
+        }
+        _verified += marked;
+    }
+
+    emit progress();
+
+    if(_verifyDone.count(true) == _verifyDone.size())
+        finish();
+}
+
+///
+/// \brief ModbusBulkWriter::startVerify
+///
+void ModbusBulkWriter::startVerify()
+{
+    _verifying = true;
+    _timer.start();
+
+    const auto pointType = _expected.registerType();
+    const int maxCount = (pointType == QModbusDataUnit::Coils) ? ModbusLimits::bitsLengthRange().to()
+                                                               : ModbusLimits::lengthRange().to();
+
+    // batched reads of the largest size allowed, sent ahead of the polls
+    const int end = _expected.startAddress() + _expected.valueCount();
+    for(int addr = _expected.startAddress(); _inProgress && addr < end; addr += maxCount)
+    {
+        const int count = qMin(maxCount, end - addr);
+        if(!_client.sendReadRequest(pointType, addr, count, _server, RequestId, true))
+            _failed += markDone(_verifyDone, addr, count);
+    }
+
+    if(!_inProgress)
+        return;
+
+    emit progress();
+
+    if(_verifyDone.count(true) == _verifyDone.size())
+        finish();
+}
+
+///
+/// \brief ModbusBulkWriter::finish
+///
+void ModbusBulkWriter::finish()
+{
+    _inProgress = false;
+    emit finished();
+}
+
+///
+/// \brief ModbusBulkWriter::loadValues
+/// \param filename text file with one or more values per line, decimal or 0x-prefixed hex
+/// \return
+///
+QVector<quint16> ModbusBulkWriter::loadValues(const QString& filename)
+{
+    QVector<quint16> values;
+
+    QFile file(filename);
+    if(!file.open(QFile::ReadOnly | QFile::Text))
+        return values;
+
+    const QRegularExpression separators("[,;\\s]+");
+
+    QTextStream ts(&file);
+    while(!ts.atEnd())
+    {
+        const auto fields = ts.readLine().split(separators);
+        for(auto&& field : fields)
+        {
+            bool ok;
+            const qint64 value = field.startsWith("0x", Qt::CaseInsensitive) ? qint64(field.mid(2).toUInt(&ok, 16)) : qint64(field.toInt(&ok));
+            if(ok && value >= SHRT_MIN && value <= USHRT_MAX)
+                values.push_back(static_cast<quint16>(value));
+        }
+    }
+
+    return values;
+}
@@ -0,0 +1,70 @@
+#ifndef MODBUSBULKWRITER_H
+#define MODBUSBULKWRITER_H
+
+#include <QObject>
+#include <QBitArray>
+#include <QElapsedTimer>
+#include "modbusclient.h"
+
+///
+/// \brief The ModbusBulkWriter class writes a block of any length and optionally reads it back to verify
+///
+class ModbusBulkWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int RequestId = -2;
+
+    explicit ModbusBulkWriter(ModbusClient& client, QObject* parent = nullptr);
+    ~ModbusBulkWriter() override;
+
+    void start(QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params, bool verify);
+    void cancel();
+
+    bool inProgress() const { return _inProgress; }
+    bool isVerifying() const { return _verifying; }
+
+    int total() const { return _expected.valueCount(); }
+    int written() const { return _written; }
+    int verified() const { return _verified; }
+    int failed() const { return _failed; }
+    int mismatched() const { return _mismatched; }
+    double throughput() const;
+
+    static QVector<quint16> loadValues(const QString& filename);
+
+signals:
+    void progress();
+    void finished();
+
+private slots:
+    void on_modbusReply(QModbusReply* reply);
+    void on_modbusError(const QString& error, int requestId);
+    void on_modbusDisconnected();
+
+private:
+    int markDone(QBitArray& done, int startAddress, int count);
+    void processWriteReply(QModbusReply* reply, const QModbusDataUnit& data);
+    void processReadReply(QModbusReply* reply, const QModbusDataUnit& request);
+    void startVerify();
+    void finish();
+
+private:
+    ModbusClient& _client;
+    int _server;
+    bool _verify;
+    bool _inProgress;
+    bool _verifying;
+    int _written;
+    int _verified;
+    int _failed;
+    int _mismatched;
+    int _replyErrors;
+    QModbusDataUnit _expected;
+    QBitArray _writeDone;
+    QBitArray _verifyDone;
+    QElapsedTimer _timer;
+};
+
+#endif // MODBUSBULKWRITER_H
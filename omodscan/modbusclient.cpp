@@ -10,6 +10,7 @@ typedef QModbusRtuSerialMaster QModbusRtuSerialClient;
 #include "formatutils.h"
 #include "numericutils.h"
 #include "modbusexception.h"
+#include "modbuslimits.h"
 #include "modbusclient.h"
 
 ///
@@ -21,6 +22,7 @@ ModbusClient::ModbusClient(QObject *parent)
     ,_modbusClient(nullptr)
     ,_connectionType(ConnectionType::Serial)
 {
+    _clock.start();
 }
 
 ///
@@ -76,9 +78,18 @@ void ModbusClient::connectDevice(const ConnectionDetails& cd)
         break;
     }
 
+    _inFlight = 0;
+    _requestQueue.clear();
+    _requestQueue.resetWaitStatistics();
+    _writeQueue.clear();
+    _timeout = cd.ModbusParams.SlaveResponseTimeOut;
+    _numberOfRetries = cd.ModbusParams.NumberOfRetries;
+    _deviceMonitor.setup(_timeout);
+
     if(_modbusClient)
     {
         _connectionType = cd.Type;
+        _maxInFlight = (cd.Type == ConnectionType::Serial) ? 1 : MaxTcpRequests;
         connect(_modbusClient, &QModbusDevice::stateChanged, this, &ModbusClient::on_stateChanged);
         connect(_modbusClient, &QModbusDevice::errorOccurred, this, &ModbusClient::on_errorOccurred);
         _modbusClient->connectDevice();
@@ -132,22 +143,13 @@ void ModbusClient::sendRawRequest(const QModbusRequest& request, int server, int
         return;
     }
 
-    emit modbusRequest(requestId, server, ++_transactionId, request);
-    if(auto reply = _modbusClient->sendRawRequest(request, server))
-    {
-        reply->setProperty("RequestId", requestId);
-        reply->setProperty("TransactionId", _transactionId);
-        if (!reply->isFinished())
-        {
-            connect(reply, &QModbusReply::finished, this, &ModbusClient::on_readReply);
-        }
-        else
-        {
-            delete reply; // broadcast replies return immediately
-        }
-    }
-    else
-        emit modbusError(tr("Invalid Modbus Request"), requestId);
+    ModbusPendingRequest req;
+    req.Type = ModbusPendingRequest::Raw;
+    req.RequestId = requestId;
+    req.Server = server;
+    req.Request = request;
+
+    enqueueRequest(req, true);
 }
 
 ///
@@ -157,33 +159,28 @@ void ModbusClient::sendRawRequest(const QModbusRequest& request, int server, int
 /// \param valueCount
 /// \param server
 /// \param requestId
+/// \param interactive
+/// \return false if the request was not queued and no reply will come for it
 ///
-void ModbusClient::sendReadRequest(QModbusDataUnit::RegisterType pointType, int startAddress, quint16 valueCount, int server, int requestId)
+bool ModbusClient::sendReadRequest(QModbusDataUnit::RegisterType pointType, int startAddress, quint16 valueCount, int server, int requestId, bool interactive)
 {
     if(_modbusClient == nullptr || state() != QModbusDevice::ConnectedState)
     {
-        return;
+        return false;
     }
 
     const QModbusDataUnit dataUnit(pointType, startAddress, valueCount);
     const auto request = createReadRequest(dataUnit);
-    if(!request.isValid()) return;
+    if(!request.isValid()) return false;
 
-    emit modbusRequest(requestId, server, ++_transactionId, request);
-    if(auto reply = _modbusClient->sendReadRequest(dataUnit, server))
-    {
-        reply->setProperty("RequestId", requestId);
-        reply->setProperty("TransactionId", _transactionId);
-        reply->setProperty("RequestData", QVariant::fromValue(dataUnit));
-        if (!reply->isFinished())
-        {
-            connect(reply, &QModbusReply::finished, this, &ModbusClient::on_readReply);
-        }
-        else
-        {
-            delete reply; // broadcast replies return immediately
-        }
-    }
+    ModbusPendingRequest req;
+    req.Type = ModbusPendingRequest::Read;
+    req.RequestId = requestId;
+    req.Server = server;
+    req.Request = request;
+    req.DataUnit = dataUnit;
+
+    return enqueueRequest(req, interactive);
 }
 
 ///
@@ -398,26 +395,26 @@ QModbusDataUnit createHoldingRegistersDataUnit(int newStartAddress, const QVecto
 }
 
 ///
-/// \brief ModbusClient::writeRegister
+/// \brief createWriteDataUnit
 /// \param pointType
 /// \param params
-/// \param requestId
+/// \return
 ///
-void ModbusClient::writeRegister(QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params, int requestId)
+QModbusDataUnit createWriteDataUnit(QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params)
 {
     QModbusDataUnit data;
     const auto addr = params.ZeroBasedAddress ? params.Address : params.Address - 1;
 
-    if(params.Value.userType() == qMetaTypeId<QVector<quint16>>())
+    if(params.Value.isWords())
     {
         switch (pointType)
         {
             case QModbusDataUnit::Coils:
-                data = createCoilsDataUnit(addr, params.Value.value<QVector<quint16>>());
+                data = createCoilsDataUnit(addr, params.Value.toWords());
             break;
 
             case QModbusDataUnit::HoldingRegisters:
-                data = createHoldingRegistersDataUnit(addr, params.Value.value<QVector<quint16>>(), params.Order);
+                data = createHoldingRegistersDataUnit(addr, params.Value.toWords(), params.Order);
             break;
 
             default:
@@ -439,7 +436,7 @@ void ModbusClient::writeRegister(QModbusDataUnit::RegisterType pointType, const
                     case DataDisplayMode::UInt16:
                     case DataDisplayMode::Int16:
                     case DataDisplayMode::Hex:
-                        data = createHoldingRegistersDataUnit(addr, params.Value.toUInt(), params.Order);
+                        data = createHoldingRegistersDataUnit(addr, params.Value.value<quint16>(), params.Order);
                     break;
                     case DataDisplayMode::FloatingPt:
                         data = createHoldingRegistersDataUnit(addr, params.Value.toFloat(), params.Order, false);
@@ -481,47 +478,85 @@ void ModbusClient::writeRegister(QModbusDataUnit::RegisterType pointType, const
         }
     }
 
+    return data;
+}
+
+///
+/// \brief ModbusClient::writeRegister
+/// \param pointType
+/// \param params
+/// \param requestId
+/// \param priority
+///
+void ModbusClient::writeRegister(QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params, int requestId, RequestPriority priority)
+{
+    const auto data = createWriteDataUnit(pointType, params);
+
     if(_modbusClient == nullptr ||
        _modbusClient->state() != QModbusDevice::ConnectedState)
     {
-        QString errorDesc;
-        switch(pointType)
-        {
-            case QModbusDataUnit::Coils:
-                errorDesc = tr("Coil Write Failure");
-            break;
+        writeFailed(pointType, requestId);
+        return;
+    }
 
-            case QModbusDataUnit::HoldingRegisters:
-                errorDesc = tr("Register Write Failure");
-            break;
+    _writeQueue.enqueue(params.Node, data, requestId, priority, params.Value.isWords() ? 1 : int(data.valueCount()));
+    _requestQueue.enqueueWrite(priority);
+    processQueue();
+}
 
-            default:
-            break;
-        }
+///
+/// \brief ModbusClient::writeRegisters
+/// \param pointType
+/// \param params
+/// \param requestId
+/// \param priority
+///
+void ModbusClient::writeRegisters(QModbusDataUnit::RegisterType pointType, const QVector<ModbusWriteParams>& params, int requestId, RequestPriority priority)
+{
+    if(params.isEmpty())
+        return;
 
-        emit modbusError(errorDesc, requestId);
+    if(_modbusClient == nullptr ||
+       _modbusClient->state() != QModbusDevice::ConnectedState)
+    {
+        writeFailed(pointType, requestId);
         return;
     }
 
-    const bool useMultipleWriteFunc = _modbusClient->property("ForceModbus15And16Func").toBool();
-    const auto request = createWriteRequest(data, useMultipleWriteFunc);
-    if(!request.isValid()) return;
+    // values pile up in the write queue while the bus is busy and go out merged
+    for(auto&& p : params)
+    {
+        const auto data = createWriteDataUnit(pointType, p);
+        _writeQueue.enqueue(p.Node, data, requestId, priority, p.Value.isWords() ? 1 : int(data.valueCount()));
+    }
+
+    _requestQueue.enqueueWrite(priority);
+    processQueue();
+}
 
-    emit modbusRequest(requestId, params.Node, ++_transactionId, request);
-    if(auto reply = _modbusClient->sendRawRequest(request, params.Node))
+///
+/// \brief ModbusClient::writeFailed
+/// \param pointType
+/// \param requestId
+///
+void ModbusClient::writeFailed(QModbusDataUnit::RegisterType pointType, int requestId)
+{
+    QString errorDesc;
+    switch(pointType)
     {
-        reply->setProperty("RequestId", requestId);
-        reply->setProperty("TransactionId", _transactionId);
-        if (!reply->isFinished())
-        {
-            connect(reply, &QModbusReply::finished, this, &ModbusClient::on_writeReply);
-        }
-        else
-        {
-            // broadcast replies return immediately
-            reply->deleteLater();
-        }
+        case QModbusDataUnit::Coils:
+            errorDesc = tr("Coil Write Failure");
+        break;
+
+        case QModbusDataUnit::HoldingRegisters:
+            errorDesc = tr("Register Write Failure");
+        break;
+
+        default:
+        break;
     }
+
+    emit modbusError(errorDesc, requestId);
 }
 
 ///
@@ -540,21 +575,182 @@ void ModbusClient::maskWriteRegister(const ModbusMaskWriteParams& params, int re
 
     const auto addr = params.ZeroBasedAddress ? params.Address : params.Address - 1;
     QModbusRequest request(QModbusRequest::MaskWriteRegister, quint16(addr), params.AndMask, params.OrMask);
-    emit modbusRequest(requestId, params.Node, ++_transactionId, request);
 
-    if(auto reply = _modbusClient->sendRawRequest(request, params.Node))
+    ModbusPendingRequest req;
+    req.Type = ModbusPendingRequest::Write;
+    req.RequestId = requestId;
+    req.Server = params.Node;
+    req.Request = request;
+
+    enqueueRequest(req, true);
+}
+
+///
+/// \brief ModbusClient::cancelRequests
+/// \param requestId drops the writes and requests of the id that have not been sent yet
+///
+void ModbusClient::cancelRequests(int requestId)
+{
+    _writeQueue.remove(requestId);
+    _requestQueue.remove(requestId);
+}
+
+///
+/// \brief ModbusClient::enqueueRequest
+/// \param req
+/// \param interactive
+/// \return false if an identical poll is already queued
+///
+bool ModbusClient::enqueueRequest(const ModbusPendingRequest& req, bool interactive)
+{
+    if(!_requestQueue.enqueue(req, interactive))
+        return false;
+
+    processQueue();
+    return true;
+}
+
+///
+/// \brief ModbusClient::processQueue
+///
+void ModbusClient::processQueue()
+{
+    while(_inFlight < _maxInFlight && !_requestQueue.isEmpty())
     {
-        reply->setProperty("RequestId", requestId);
-        reply->setProperty("TransactionId", _transactionId);
-        if (!reply->isFinished())
+        if(_modbusClient == nullptr || state() != QModbusDevice::ConnectedState)
         {
-            connect(reply, &QModbusReply::finished, this, &ModbusClient::on_writeReply);
+            _requestQueue.clear();
+            _writeQueue.clear();
+            return;
         }
-        else
+
+        auto req = _requestQueue.dequeue();
+        if(req.RequestId == ModbusRequestQueue::WriteRequestId)
+        {
+            // the request queue only decides when the writes get the bus, the values come from the write queue
+            if(!_writeQueue.contains(req.Priority))
+                continue;
+
+            req = takeWriteRequest(req.Priority);
+            if(_writeQueue.contains(req.Priority))
+                _requestQueue.enqueueWrite(req.Priority);
+        }
+
+        if(!req.Request.isValid() && req.Type == ModbusPendingRequest::Write)
+        {
+            dropRequest(req, tr("Invalid Modbus Request"));
+            continue;
+        }
+
+        if(req.Priority != RequestPriority::Interactive && !_deviceMonitor.allowRequest(req.Server))
         {
-            // broadcast replies return immediately
-            reply->deleteLater();
+            // device does not respond, skip polls until the next recovery probe
+            dropRequest(req, tr("No Responses from Slave Device"));
+            continue;
         }
+
+        sendRequest(req);
+    }
+}
+
+///
+/// \brief ModbusClient::dropRequest
+/// \param req
+/// \param error
+///
+void ModbusClient::dropRequest(const ModbusPendingRequest& req, const QString& error)
+{
+    // no reply will come for the request, every producer gets the error instead
+    if(req.RequestIds.isEmpty())
+    {
+        emit modbusError(error, req.RequestId);
+        return;
+    }
+
+    for(auto&& requestId : req.RequestIds)
+        emit modbusError(error, requestId);
+}
+
+///
+/// \brief ModbusClient::takeWriteRequest
+/// \param priority
+/// \return the next run of pending values of the priority as a single write request
+///
+ModbusPendingRequest ModbusClient::takeWriteRequest(RequestPriority priority)
+{
+    const auto block = _writeQueue.dequeue(priority, ModbusLimits::writeLengthRange().to(), ModbusLimits::writeBitsLengthRange().to());
+    const bool useMultipleWriteFunc = _modbusClient->property("ForceModbus15And16Func").toBool();
+
+    ModbusPendingRequest req;
+    req.Type = ModbusPendingRequest::Write;
+    req.RequestId = block.RequestIds.value(0);
+    req.RequestIds = block.RequestIds;
+    req.Server = block.Server;
+    req.Request = createWriteRequest(block.DataUnit, useMultipleWriteFunc);
+    req.DataUnit = block.DataUnit;
+    req.Priority = priority;
+
+    return req;
+}
+
+///
+/// \brief ModbusClient::sendRequest
+/// \param req
+///
+void ModbusClient::sendRequest(const ModbusPendingRequest& req)
+{
+    const auto timeout = _deviceMonitor.timeout(req.Server);
+    _modbusClient->setTimeout(timeout);
+
+    // the retry count is a client-wide setting, so a probe goes out without retries
+    // only on a serial line where no other request can be in flight
+    const bool singleProbe = _connectionType == ConnectionType::Serial && _deviceMonitor.isProbe(req.Server);
+    if(singleProbe) _modbusClient->setNumberOfRetries(0);
+
+    emit modbusRequest(req.RequestId, req.Server, ++_transactionId, req.Request);
+
+    QModbusReply* reply = nullptr;
+    switch(req.Type)
+    {
+        case ModbusPendingRequest::Read:
+            reply = _modbusClient->sendReadRequest(req.DataUnit, req.Server);
+        break;
+
+        case ModbusPendingRequest::Raw:
+        case ModbusPendingRequest::Write:
+            reply = _modbusClient->sendRawRequest(req.Request, req.Server);
+        break;
+    }
+
+    if(singleProbe) _modbusClient->setNumberOfRetries(_numberOfRetries);
+
+    if(!reply)
+    {
+        dropRequest(req, tr("Invalid Modbus Request"));
+        return;
+    }
+
+    reply->setProperty("RequestId", req.RequestId);
+    if(!req.RequestIds.isEmpty())
+        reply->setProperty("RequestIds", QVariant::fromValue(req.RequestIds));
+    reply->setProperty("TransactionId", _transactionId);
+    reply->setProperty("SentTime", _clock.elapsed());
+    reply->setProperty("Timeout", timeout);
+    if(req.Type != ModbusPendingRequest::Raw)
+        reply->setProperty("RequestData", QVariant::fromValue(req.DataUnit));
+
+    if (!reply->isFinished())
+    {
+        _inFlight++;
+        if(req.Type == ModbusPendingRequest::Write)
+            connect(reply, &QModbusReply::finished, this, &ModbusClient::on_writeReply);
+        else
+            connect(reply, &QModbusReply::finished, this, &ModbusClient::on_readReply);
+    }
+    else
+    {
+        // broadcast replies return immediately
+        reply->deleteLater();
     }
 }
 
@@ -586,7 +782,7 @@ QModbusDevice::State ModbusClient::state() const
 int ModbusClient::timeout() const
 {
     if(_modbusClient)
-        return _modbusClient->timeout();
+        return _timeout;
 
     return 0;
 }
@@ -598,7 +794,11 @@ int ModbusClient::timeout() const
 void ModbusClient::setTimeout(int newTimeout)
 {
     if(_modbusClient)
+    {
+        _timeout = newTimeout;
+        _deviceMonitor.setup(newTimeout);
         _modbusClient->setTimeout(newTimeout);
+    }
 }
 
 ///
@@ -608,7 +808,7 @@ void ModbusClient::setTimeout(int newTimeout)
 uint ModbusClient::numberOfRetries() const
 {
     if(_modbusClient)
-        return _modbusClient->numberOfRetries();
+        return _numberOfRetries;
 
     return 0;
 }
@@ -620,7 +820,117 @@ uint ModbusClient::numberOfRetries() const
 void ModbusClient::setNumberOfRetries(uint number)
 {
     if(_modbusClient)
+    {
+        _numberOfRetries = number;
         _modbusClient->setNumberOfRetries(number);
+    }
+}
+
+///
+/// \brief ModbusClient::deviceTimeout
+/// \param server
+/// \return
+///
+int ModbusClient::deviceTimeout(int server) const
+{
+    return _deviceMonitor.timeout(server);
+}
+
+///
+/// \brief ModbusClient::circuitState
+/// \param server
+/// \return
+///
+CircuitState ModbusClient::circuitState(int server) const
+{
+    return _deviceMonitor.circuitState(server);
+}
+
+///
+/// \brief ModbusClient::updateDeviceMonitor
+/// \param reply
+///
+void ModbusClient::updateDeviceMonitor(const QModbusReply* reply)
+{
+    const auto server = reply->serverAddress();
+    const auto rtt = _clock.elapsed() - reply->property("SentTime").toLongLong();
+    const auto timeout = reply->property("Timeout").toInt();
+
+    switch(reply->error())
+    {
+        case QModbusDevice::NoError:
+        case QModbusDevice::ProtocolError:
+            _deviceMonitor.responseReceived(server, rtt, timeout);
+        break;
+
+        default:
+            _deviceMonitor.requestFailed(server, reply->error() == QModbusDevice::TimeoutError);
+        break;
+    }
+}
+
+///
+/// \brief ModbusClient::activeRequestId
+/// \return
+///
+int ModbusClient::activeRequestId() const
+{
+    return _requestQueue.activeRequestId();
+}
+
+///
+/// \brief ModbusClient::setActiveRequestId
+/// \param requestId
+///
+void ModbusClient::setActiveRequestId(int requestId)
+{
+    _requestQueue.setActiveRequestId(requestId);
+}
+
+///
+/// \brief ModbusClient::maxInFlight
+/// \return
+///
+int ModbusClient::maxInFlight() const
+{
+    return _maxInFlight;
+}
+
+///
+/// \brief ModbusClient::pendingRequests
+/// \return
+///
+int ModbusClient::pendingRequests() const
+{
+    return _requestQueue.size();
+}
+
+///
+/// \brief ModbusClient::pendingWrites
+/// \return
+///
+int ModbusClient::pendingWrites() const
+{
+    return _writeQueue.size();
+}
+
+///
+/// \brief ModbusClient::collapsedWrites
+/// \return number of writes merged into others or replaced by newer values before they were sent
+///
+quint64 ModbusClient::collapsedWrites() const
+{
+    return _writeQueue.collapsed();
+}
+
+///
+/// \brief ModbusClient::queueWaitStatistics
+/// \param priority
+/// \return
+///
+QueueWaitStatistics ModbusClient::queueWaitStatistics(RequestPriority priority) const
+{
+    return _requestQueue.waitStatistics(priority);
 }
 
 ///
@@ -631,8 +941,13 @@ void ModbusClient::on_readReply()
     auto reply = qobject_cast<QModbusReply*>(sender());
     if (!reply) return;
 
+    _inFlight = qMax(0, _inFlight - 1);
+    updateDeviceMonitor(reply);
+
     emit modbusReply(reply);
     reply->deleteLater();
+
+    processQueue();
 }
 
 ///
@@ -643,6 +958,9 @@ void ModbusClient::on_writeReply()
     auto reply = qobject_cast<QModbusReply*>(sender());
     if (!reply) return;
 
+    _inFlight = qMax(0, _inFlight - 1);
+    updateDeviceMonitor(reply);
+
     const auto raw  = reply->rawResult();
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
@@ -668,28 +986,36 @@ void ModbusClient::on_writeReply()
             emit modbusError(QString("%1. %2").arg(errorDesc, reply->errorString()), requestId);
     };
 
-    const int requestId = reply->property("RequestId").toInt();
-    switch(raw.functionCode())
+    // a merged write reports to every form whose values it carried
+    auto requestIds = reply->property("RequestIds").value<QList<int>>();
+    if(requestIds.isEmpty())
+        requestIds.push_back(reply->property("RequestId").toInt());
+
+    for(auto&& requestId : requestIds)
     {
-        case QModbusRequest::WriteSingleCoil:
-        case QModbusRequest::WriteMultipleCoils:
-            onError(tr("Coil Write Failure"), requestId);
-        break;
+        switch(raw.functionCode())
+        {
+            case QModbusRequest::WriteSingleCoil:
+            case QModbusRequest::WriteMultipleCoils:
+                onError(tr("Coil Write Failure"), requestId);
+            break;
 
-        case QModbusRequest::WriteSingleRegister:
-        case QModbusRequest::WriteMultipleRegisters:
-            onError(tr("Register Write Failure"), requestId);
-        break;
+            case QModbusRequest::WriteSingleRegister:
+            case QModbusRequest::WriteMultipleRegisters:
+                onError(tr("Register Write Failure"), requestId);
+            break;
 
-        case QModbusRequest::MaskWriteRegister:
-            onError(tr("Mask Register Write Failure"), requestId);
-        break;
+            case QModbusRequest::MaskWriteRegister:
+                onError(tr("Mask Register Write Failure"), requestId);
+            break;
 
-    default:
-        break;
+        default:
+            break;
+        }
     }
 
     reply->deleteLater();
+    processQueue();
 }
 
 ///
@@ -739,6 +1065,9 @@ void ModbusClient::on_stateChanged(QModbusDevice::State state)
         break;
 
         case QModbusDevice::UnconnectedState:
+            _inFlight = 0;
+            _requestQueue.clear();
+            _writeQueue.clear();
             emit modbusDisconnected(cd);
         break;
 
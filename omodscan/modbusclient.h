@@ -1,12 +1,18 @@
 #ifndef MODBUSCLIENT_H
 #define MODBUSCLIENT_H
 
+#include <QElapsedTimer>
 #include <QModbusClient>
 #include "connectiondetails.h"
 #include "modbuswriteparams.h"
+#include "modbusrequestqueue.h"
+#include "modbuswritequeue.h"
+#include "modbusdevicemonitor.h"
 
 Q_DECLARE_METATYPE(QModbusDataUnit)
 
+QModbusDataUnit createWriteDataUnit(QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params);
+
 ///
 /// \brief The ModbusClient class
 ///
@@ -14,6 +20,8 @@ class ModbusClient : public QObject
 {
     Q_OBJECT
 public:
+    static const int MaxTcpRequests = 16;
+
     explicit ModbusClient(QObject *parent = nullptr);
     ~ModbusClient() override;
 
@@ -33,10 +41,25 @@ public:
     uint numberOfRetries() const;
     void setNumberOfRetries(uint number);
 
+    int maxInFlight() const;
+
+    int activeRequestId() const;
+    void setActiveRequestId(int requestId);
+
+    int pendingRequests() const;
+    int pendingWrites() const;
+    quint64 collapsedWrites() const;
+    QueueWaitStatistics queueWaitStatistics(RequestPriority priority) const;
+
+    int deviceTimeout(int server) const;
+    CircuitState circuitState(int server) const;
+
     void sendRawRequest(const QModbusRequest& request, int server, int requestId);
-    void sendReadRequest(QModbusDataUnit::RegisterType pointType, int startAddress, quint16 valueCount, int server, int requestId);
-    void writeRegister(QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params, int requestId);
+    bool sendReadRequest(QModbusDataUnit::RegisterType pointType, int startAddress, quint16 valueCount, int server, int requestId, bool interactive = false);
+    void writeRegister(QModbusDataUnit::RegisterType pointType, const ModbusWriteParams& params, int requestId, RequestPriority priority = RequestPriority::Interactive);
+    void writeRegisters(QModbusDataUnit::RegisterType pointType, const QVector<ModbusWriteParams>& params, int requestId, RequestPriority priority = RequestPriority::Interactive);
     void maskWriteRegister(const ModbusMaskWriteParams& params, int requestId);
+    void cancelRequests(int requestId);
 
 signals:
     void modbusRequest(int requestId, int deviceId, int transactionId, const QModbusRequest& request);
@@ -53,10 +76,27 @@ private slots:
     void on_errorOccurred(QModbusDevice::Error error);
     void on_stateChanged(QModbusDevice::State state);
 
+private:
+    bool enqueueRequest(const ModbusPendingRequest& req, bool interactive);
+    void processQueue();
+    void sendRequest(const ModbusPendingRequest& req);
+    ModbusPendingRequest takeWriteRequest(RequestPriority priority);
+    void dropRequest(const ModbusPendingRequest& req, const QString& error);
+    void updateDeviceMonitor(const QModbusReply* reply);
+    void writeFailed(QModbusDataUnit::RegisterType pointType, int requestId);
+
 private:
     int _transactionId = -1;
+    int _inFlight = 0;
+    int _maxInFlight = 1;
+    int _timeout = 0;
+    uint _numberOfRetries = 0;
+    QElapsedTimer _clock;
     QModbusClient* _modbusClient;
     ConnectionType _connectionType;
+    ModbusRequestQueue _requestQueue;
+    ModbusWriteQueue _writeQueue;
+    ModbusDeviceMonitor _deviceMonitor;
 };
 
 #endif // MODBUSCLIENT_H
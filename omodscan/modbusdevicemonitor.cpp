@@ -0,0 +1,166 @@
+#include "modbusdevicemonitor.h"
+
+///
+/// \brief ModbusDeviceMonitor::ModbusDeviceMonitor
+///
+ModbusDeviceMonitor::ModbusDeviceMonitor()
+    :_maxTimeout(1000)
+{
+}
+
+///
+/// \brief ModbusDeviceMonitor::setup
+/// \param timeout
+///
+void ModbusDeviceMonitor::setup(int timeout)
+{
+    _maxTimeout = qMax<int>(MinTimeout, timeout);
+    _devices.clear();
+}
+
+///
+/// \brief ModbusDeviceMonitor::clear
+///
+void ModbusDeviceMonitor::clear()
+{
+    _devices.clear();
+}
+
+///
+/// \brief ModbusDeviceMonitor::timeout
+/// \param server
+/// \return
+///
+int ModbusDeviceMonitor::timeout(int server) const
+{
+    const auto it = _devices.constFind(server);
+    if(it == _devices.cend() || it->Srtt < 0)
+        return _maxTimeout;
+
+    return qBound<int>(MinTimeout, it->Rto, _maxTimeout);
+}
+
+///
+/// \brief ModbusDeviceMonitor::isProbe
+/// \param server
+/// \return
+///
+bool ModbusDeviceMonitor::isProbe(int server) const
+{
+    return circuitState(server) == CircuitState::HalfOpen;
+}
+
+///
+/// \brief ModbusDeviceMonitor::circuitState
+/// \param server
+/// \return
+///
+CircuitState ModbusDeviceMonitor::circuitState(int server) const
+{
+    const auto it = _devices.constFind(server);
+    return it == _devices.cend() ? CircuitState::Closed : it->State;
+}
+
+///
+/// \brief ModbusDeviceMonitor::statistics
+/// \param server
+/// \return
+///
+DeviceLinkStatistics ModbusDeviceMonitor::statistics(int server) const
+{
+    return _devices.value(server);
+}
+
+///
+/// \brief ModbusDeviceMonitor::allowRequest
+/// \param server
+/// \return
+///
+bool ModbusDeviceMonitor::allowRequest(int server)
+{
+    auto it = _devices.find(server);
+    if(it == _devices.end())
+        return true;
+
+    switch(it->State)
+    {
+        case CircuitState::Closed:
+        return true;
+
+        case CircuitState::Open:
+            if(it->OpenTimer.elapsed() < it->ProbeInterval)
+                return false;
+
+            // let a single probe request through
+            it->State = CircuitState::HalfOpen;
+        return true;
+
+        case CircuitState::HalfOpen:
+        return false;
+    }
+
+    return true;
+}
+
+///
+/// \brief ModbusDeviceMonitor::responseReceived
+/// \param server
+/// \param rtt
+/// \param timeout
+///
+void ModbusDeviceMonitor::responseReceived(int server, qint64 rtt, int timeout)
+{
+    auto& stat = _devices[server];
+    stat.Failures = 0;
+    stat.ProbeInterval = 0;
+    stat.State = CircuitState::Closed;
+
+    // Karn's rule: a response that arrived after a retry gives an ambiguous sample
+    if(rtt > timeout)
+        return;
+
+    if(stat.Srtt < 0)
+    {
+        stat.Srtt = rtt;
+        stat.RttVar = rtt / 2;
+    }
+    else
+    {
+        stat.RttVar = (3 * stat.RttVar + qAbs(stat.Srtt - rtt)) / 4;
+        stat.Srtt = (7 * stat.Srtt + rtt) / 8;
+    }
+
+    stat.Rto = stat.Srtt + qMax<qint64>(10, 4 * stat.RttVar);
+}
+
+///
+/// \brief ModbusDeviceMonitor::requestFailed
+/// \param server
+/// \param timedOut true if the device did not answer in time, false for any other failure
+///
+void ModbusDeviceMonitor::requestFailed(int server, bool timedOut)
+{
+    auto& stat = _devices[server];
+    stat.Failures++;
+
+    // only a missed response says something about the round trip time
+    if(timedOut && stat.Srtt >= 0)
+        stat.Rto = qMin<qint64>(stat.Rto * 2, _maxTimeout);
+
+    // a probe that fails for whatever reason must not leave the circuit half open;
+    // failures of requests still in flight while it is open do not extend the back-off
+    if(stat.State == CircuitState::HalfOpen ||
+       (stat.State == CircuitState::Closed && stat.Failures >= FailureThreshold))
+        openCircuit(stat);
+}
+
+///
+/// \brief ModbusDeviceMonitor::openCircuit
+/// \param stat
+///
+void ModbusDeviceMonitor::openCircuit(DeviceLinkStatistics& stat)
+{
+    stat.State = CircuitState::Open;
+    stat.ProbeInterval = (stat.ProbeInterval == 0) ? MinProbeInterval : qMin<qint64>(stat.ProbeInterval * 2, MaxProbeInterval);
+    stat.OpenTimer.start();
+}
@@ -0,0 +1,64 @@
+#ifndef MODBUSDEVICEMONITOR_H
+#define MODBUSDEVICEMONITOR_H
+
+#include <QMap>
+#include <QElapsedTimer>
+
+///
+/// \brief The CircuitState enum
+///
+enum class CircuitState
+{
+    Closed = 0,
+    Open,
+    HalfOpen
+};
+
+///
+/// \brief The DeviceLinkStatistics struct
+///
+struct DeviceLinkStatistics
+{
+    qint64 Srtt = -1;
+    qint64 RttVar = 0;
+    qint64 Rto = 0;
+    int Failures = 0;
+    qint64 ProbeInterval = 0;
+    CircuitState State = CircuitState::Closed;
+    QElapsedTimer OpenTimer;
+};
+
+///
+/// \brief The ModbusDeviceMonitor class
+///
+class ModbusDeviceMonitor
+{
+public:
+    static constexpr int MinTimeout = 50;
+    static constexpr int FailureThreshold = 3;
+    static constexpr int MinProbeInterval = 2000;
+    static constexpr int MaxProbeInterval = 30000;
+
+    ModbusDeviceMonitor();
+
+    void setup(int timeout);
+    void clear();
+
+    int timeout(int server) const;
+    bool isProbe(int server) const;
+    CircuitState circuitState(int server) const;
+    DeviceLinkStatistics statistics(int server) const;
+
+    bool allowRequest(int server);
+    void responseReceived(int server, qint64 rtt, int timeout);
+    void requestFailed(int server, bool timedOut);
+
+private:
+    void openCircuit(DeviceLinkStatistics& stat);
+
+private:
+    int _maxTimeout;
+    QMap<int, DeviceLinkStatistics> _devices;
+};
+
+#endif // MODBUSDEVICEMONITOR_H
@@ -0,0 +1,236 @@
+#include <QDataStream>
+#include "formatutils.h"
+#include "modbusexception.h"
+#include "readfifoqueue.h"
+#include "modbusfiforeader.h"
+
+///
+/// \brief ModbusFifoReader::ModbusFifoReader
+/// \param client
+/// \param parent
+///
+ModbusFifoReader::ModbusFifoReader(ModbusClient& client, QObject* parent)
+    : QObject(parent)
+    ,_client(client)
+    ,_running(false)
+    ,_waiting(false)
+    ,_reads(0)
+    ,_entries(0)
+    ,_overflows(0)
+    ,_errors(0)
+    ,_maxFill(0)
+{
+    _timer.setSingleShot(true);
+
+    connect(&_timer, &QTimer::timeout, this, &ModbusFifoReader::on_timeout);
+    connect(&_client, &ModbusClient::modbusReply, this, &ModbusFifoReader::on_modbusReply);
+    connect(&_client, &ModbusClient::modbusError, this, &ModbusFifoReader::on_modbusError);
+    connect(&_client, &ModbusClient::modbusDisconnected, this, &ModbusFifoReader::on_modbusDisconnected);
+}
+
+///
+/// \brief ModbusFifoReader::~ModbusFifoReader
+///
+ModbusFifoReader::~ModbusFifoReader()
+{
+    stop();
+}
+
+///
+/// \brief ModbusFifoReader::start
+/// \param params
+/// \return
+///
+bool ModbusFifoReader::start(const FifoReadParams& params)
+{
+    stop();
+
+    _params = params;
+    _reads = _entries = _overflows = _errors = 0;
+    _maxFill = 0;
+    _error.clear();
+
+    if(_client.state() != QModbusDevice::ConnectedState)
+    {
+        _error = tr("Not connected");
+        return false;
+    }
+
+    if(!params.LogFile.isEmpty())
+    {
+        _log.setFileName(params.LogFile);
+        if(!_log.open(QFile::WriteOnly | QFile::Append))
+        {
+            _error = _log.errorString();
+            return false;
+        }
+    }
+
+    _running = true;
+    _clock.start();
+    scheduleNext(0);
+
+    return true;
+}
+
+///
+/// \brief ModbusFifoReader::stop
+///
+void ModbusFifoReader::stop()
+{
+    if(!_running)
+        return;
+
+    _timer.stop();
+    _client.cancelRequests(RequestId);
+    _running = false;
+    _waiting = false;
+    _log.close();
+}
+
+///
+/// \brief ModbusFifoReader::drainRate
+/// \return entries per second since the start
+///
+double ModbusFifoReader::drainRate() const
+{
+    const auto elapsed = _clock.isValid() ? _clock.elapsed() : 0;
+    return elapsed > 0 ? _entries * 1000. / elapsed : 0.;
+}
+
+///
+/// \brief ModbusFifoReader::scheduleNext
+/// \param delay
+///
+void ModbusFifoReader::scheduleNext(int delay)
+{
+    if(_running)
+        _timer.start(qMax(0, delay));
+}
+
+///
+/// \brief ModbusFifoReader::on_timeout
+///
+void ModbusFifoReader::on_timeout()
+{
+    if(!_running || _waiting)
+        return;
+
+    _waiting = true;
+    _sendTime.start();
+    _client.sendRawRequest(QModbusRequest(QModbusPdu::ReadFifoQueue, _params.PointerAddress), _params.DeviceId, RequestId);
+}
+
+///
+/// \brief ModbusFifoReader::on_modbusReply
+/// \param reply
+///
+void ModbusFifoReader::on_modbusReply(QModbusReply* reply)
+{
+    if(!_running || !_waiting || !reply || reply->property("RequestId").toInt() != RequestId)
+        return;
+
+    _waiting = false;
+    _reads++;
+
+    const auto response = reply->rawResult();
+    const auto timestamp = QDateTime::currentDateTime();
+
+    if(reply->error() != QModbusDevice::NoError)
+    {
+        if(reply->error() == QModbusDevice::ProtocolError)
+        {
+            ModbusException ex(response.exceptionCode());
+            _error = QString("%1 (%2)").arg(ex, formatUInt8Value(DataDisplayMode::Hex, ex));
+        }
+        else
+        {
+            _error = reply->errorString();
+        }
+
+        // an absent or refusing device should not be hammered
+        _errors++;
+        emit errorOccurred(_error);
+        scheduleNext(qMax(_params.Interval, ErrorBackoff));
+        return;
+    }
+
+    const auto protocol = _client.connectionType() == ConnectionType::Serial ? ModbusMessage::Rtu : ModbusMessage::Tcp;
+    const ReadFifoQueueResponse msg(response, protocol, reply->serverAddress(), timestamp);
+    if(!msg.isValid())
+    {
+        _errors++;
+        _error = tr("Invalid FIFO response");
+        emit errorOccurred(_error);
+        scheduleNext(qMax(_params.Interval, ErrorBackoff));
+        return;
+    }
+
+    const auto data = msg.fifoValue();
+    QVector<quint16> values(msg.fifoCount());
+    for(int i = 0; i < values.size(); i++)
+        values[i] = quint16(quint8(data[i * 2]) << 8 | quint8(data[i * 2 + 1]));
+
+    _entries += values.size();
+    _maxFill = qMax(_maxFill, values.size());
+
+    // a full queue may have dropped entries since the previous read, so read again at once
+    const bool full = values.size() >= MaxFifoCount;
+    if(full) _overflows++;
+
+    if(!values.isEmpty())
+    {
+        writeLog(timestamp, values);
+        emit entriesReceived(timestamp, values);
+    }
+
+    scheduleNext(full ? 0 : _params.Interval - int(_sendTime.elapsed()));
+}
+
+///
+/// \brief ModbusFifoReader::on_modbusError
+/// \param error
+/// \param requestId
+///
+void ModbusFifoReader::on_modbusError(const QString& error, int requestId)
+{
+    // a read the client dropped never gets a reply, without this the reader would wait forever
+    if(!_running || !_waiting || requestId != RequestId)
+        return;
+
+    _waiting = false;
+    _errors++;
+    _error = error;
+    emit errorOccurred(_error);
+    scheduleNext(qMax(_params.Interval, ErrorBackoff));
+}
+
+///
+/// \brief ModbusFifoReader::on_modbusDisconnected
+///
+void ModbusFifoReader::on_modbusDisconnected()
+{
+    if(!_running)
+        return;
+
+    _error = tr("Connection lost");
+    stop();
+    emit errorOccurred(_error);
+}
+
+///
+/// \brief ModbusFifoReader::writeLog
+/// \param timestamp
+/// \param values
+///
+void ModbusFifoReader::writeLog(const QDateTime& timestamp, const QVector<quint16>& values)
+{
+    if(!_log.isOpen())
+        return;
+
+    // each read is a big-endian record: msecs since epoch (int64), count (uint16), values (uint16)
+    QDataStream s(&_log);
+    s << qint64(timestamp.toMSecsSinceEpoch()) << quint16(values.size());
+    for(auto&& v : values)
+        s << v;
+}
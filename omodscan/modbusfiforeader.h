@@ -0,0 +1,81 @@
+#ifndef MODBUSFIFOREADER_H
+#define MODBUSFIFOREADER_H
+
+#include <QFile>
+#include <QTimer>
+#include <QObject>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include "modbusclient.h"
+
+///
+/// \brief The FifoReadParams struct
+///
+struct FifoReadParams
+{
+    quint8 DeviceId = 1;
+    quint16 PointerAddress = 0;
+    int Interval = 0;
+    QString LogFile;
+};
+
+///
+/// \brief The ModbusFifoReader class drains a FIFO queue (FC24) of a device
+///
+class ModbusFifoReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RequestId = -4;
+    static constexpr int MaxFifoCount = 31;
+    static constexpr int ErrorBackoff = 1000;
+
+    explicit ModbusFifoReader(ModbusClient& client, QObject* parent = nullptr);
+    ~ModbusFifoReader() override;
+
+    bool start(const FifoReadParams& params);
+    void stop();
+
+    bool isRunning() const { return _running; }
+    QString errorString() const { return _error; }
+
+    quint64 reads() const { return _reads; }
+    quint64 entries() const { return _entries; }
+    quint64 overflows() const { return _overflows; }
+    quint64 errors() const { return _errors; }
+    int maxFill() const { return _maxFill; }
+    double drainRate() const;
+
+signals:
+    void entriesReceived(const QDateTime& timestamp, const QVector<quint16>& values);
+    void errorOccurred(const QString& error);
+
+private slots:
+    void on_timeout();
+    void on_modbusReply(QModbusReply* reply);
+    void on_modbusError(const QString& error, int requestId);
+    void on_modbusDisconnected();
+
+private:
+    void scheduleNext(int delay);
+    void writeLog(const QDateTime& timestamp, const QVector<quint16>& values);
+
+private:
+    ModbusClient& _client;
+    FifoReadParams _params;
+    bool _running;
+    bool _waiting;
+    quint64 _reads;
+    quint64 _entries;
+    quint64 _overflows;
+    quint64 _errors;
+    int _maxFill;
+    QString _error;
+    QFile _log;
+    QTimer _timer;
+    QElapsedTimer _clock;
+    QElapsedTimer _sendTime;
+};
+
+#endif // MODBUSFIFOREADER_H
@@ -0,0 +1,488 @@
+#include <QTextStream>
+#include <QRegularExpression>
+#include "formatutils.h"
+#include "modbuslimits.h"
+#include "modbusexception.h"
+#include "modbusfiletransfer.h"
+
+///
+/// \brief Reference type of the file record sub-requests
+///
+static const quint8 FileRecordReference = 0x06;
+
+///
+/// \brief Max byte count of a read file record request and of its response
+///
+static const int MaxReadByteCount = 0xF5;
+
+///
+/// \brief Max request data length of a write file record request
+///
+static const int MaxWriteByteCount = 0xFB;
+
+///
+/// \brief Size of a sub-request header: reference type, file number, record number, record length
+///
+static const int SubRequestSize = 7;
+
+///
+/// \brief appendWord
+/// \param data
+/// \param value
+///
+static void appendWord(QByteArray& data, quint16 value)
+{
+    data.append(char(value >> 8));
+    data.append(char(value & 0xFF));
+}
+
+///
+/// \brief ModbusFileTransfer::ModbusFileTransfer
+/// \param client
+/// \param parent
+///
+ModbusFileTransfer::ModbusFileTransfer(ModbusClient& client, QObject* parent)
+    : QObject(parent)
+    ,_client(client)
+    ,_inProgress(false)
+    ,_csv(false)
+    ,_total(0)
+    ,_transferred(0)
+    ,_nextRequest(0)
+    ,_nextFlush(0)
+    ,_lineRecord(0)
+{
+    connect(&_client, &ModbusClient::modbusRequest, this, &ModbusFileTransfer::on_modbusRequest);
+    connect(&_client, &ModbusClient::modbusReply, this, &ModbusFileTransfer::on_modbusReply);
+    connect(&_client, &ModbusClient::modbusError, this, &ModbusFileTransfer::on_modbusError);
+    connect(&_client, &ModbusClient::modbusDisconnected, this, &ModbusFileTransfer::on_modbusDisconnected);
+}
+
+///
+/// \brief ModbusFileTransfer::~ModbusFileTransfer
+///
+ModbusFileTransfer::~ModbusFileTransfer()
+{
+    cancel();
+}
+
+///
+/// \brief ModbusFileTransfer::maxRecordLength
+/// \param write
+/// \return max registers a single sub-request can carry
+///
+int ModbusFileTransfer::maxRecordLength(bool write)
+{
+    // a read sub-response adds its length and reference type, a write sub-request its full header
+    return write ? (MaxWriteByteCount - SubRequestSize) / 2 : (MaxReadByteCount - 2) / 2;
+}
+
+///
+/// \brief ModbusFileTransfer::start
+/// \param params
+///
+void ModbusFileTransfer::start(const FileTransferParams& params)
+{
+    cancel();
+
+    _params = params;
+    _csv = params.FileName.endsWith(".csv", Qt::CaseInsensitive);
+    _total = params.RecordCount * params.RecordLength;
+    _transferred = 0;
+    _nextRequest = 0;
+    _nextFlush = 0;
+    _lineRecord = 0;
+    _error.clear();
+    _source.clear();
+    _line.clear();
+    _sent.clear();
+    _pending.clear();
+    _received.clear();
+
+    _inProgress = true;
+    _timer.start();
+
+    const auto error = validate();
+    if(!error.isEmpty())
+    {
+        finish(error);
+        return;
+    }
+
+    if(_params.Write)
+    {
+        if(!loadSource())
+            return;
+    }
+    else
+    {
+        _file.setFileName(params.FileName);
+        if(!_file.open(QFile::WriteOnly | QFile::Truncate | (_csv ? QFile::Text : QFile::NotOpen)))
+        {
+            finish(_file.errorString());
+            return;
+        }
+    }
+
+    buildRequests();
+    sendNext();
+}
+
+///
+/// \brief ModbusFileTransfer::cancel
+///
+void ModbusFileTransfer::cancel()
+{
+    if(!_inProgress)
+        return;
+
+    _client.cancelRequests(RequestId);
+    _inProgress = false;
+    _sent.clear();
+    _pending.clear();
+    _file.close();
+}
+
+///
+/// \brief ModbusFileTransfer::throughput
+/// \return registers per second
+///
+double ModbusFileTransfer::throughput() const
+{
+    const auto elapsed = _timer.isValid() ? _timer.elapsed() : 0;
+    return elapsed > 0 ? _transferred * 1000. / elapsed : 0.;
+}
+
+///
+/// \brief ModbusFileTransfer::validate
+/// \return an error message or an empty string
+///
+QString ModbusFileTransfer::validate() const
+{
+    if(_client.state() != QModbusDevice::ConnectedState)
+        return tr("Not connected");
+
+    if(_total == 0)
+        return tr("Nothing to transfer");
+
+    if(_params.IndexedRecords && _params.RecordLength > maxRecordLength(_params.Write))
+        return tr("A record can hold up to %1 registers").arg(maxRecordLength(_params.Write));
+
+    // with indexed records the record number counts records, otherwise registers
+    const int lastRecord = _params.StartRecord + (_params.IndexedRecords ? _params.RecordCount : _total) - 1;
+    if(lastRecord > ModbusLimits::recordNumberRange().to())
+        return tr("The transfer ends past record %1").arg(ModbusLimits::recordNumberRange().to());
+
+    return QString();
+}
+
+///
+/// \brief ModbusFileTransfer::loadSource
+/// \return
+///
+bool ModbusFileTransfer::loadSource()
+{
+    _file.setFileName(_params.FileName);
+    if(!_file.open(QFile::ReadOnly | (_csv ? QFile::Text : QFile::NotOpen)))
+    {
+        finish(_file.errorString());
+        return false;
+    }
+
+    if(_csv)
+    {
+        // the same layout the reads produce: a record number followed by its values
+        const QRegularExpression separator("[,;\\s]+");
+        QTextStream s(&_file);
+        while(!s.atEnd() && _source.size() < _total)
+        {
+            const auto fields = s.readLine().trimmed().split(separator);
+            for(int i = 1; i < fields.size(); i++)
+            {
+                // decimal unless marked hex, a leading zero does not make it octal
+                bool ok;
+                const auto value = fields[i].startsWith("0x", Qt::CaseInsensitive) ? fields[i].mid(2).toUInt(&ok, 16) : fields[i].toUInt(&ok, 10);
+                if(ok) _source.push_back(quint16(value));
+            }
+        }
+    }
+    else
+    {
+        const auto data = _file.read(_total * 2);
+        for(int i = 0; i + 1 < data.size(); i += 2)
+            _source.push_back(quint16(quint8(data[i]) << 8 | quint8(data[i + 1])));
+    }
+    _file.close();
+
+    if(_source.size() < _total)
+    {
+        finish(tr("The file holds %1 of %2 registers").arg(_source.size()).arg(_total));
+        return false;
+    }
+
+    return true;
+}
+
+///
+/// \brief ModbusFileTransfer::buildRequests
+///
+void ModbusFileTransfer::buildRequests()
+{
+    const int maxLength = maxRecordLength(_params.Write);
+
+    _subRequests.clear();
+    if(_params.IndexedRecords)
+    {
+        for(int i = 0; i < _params.RecordCount; i++)
+            _subRequests.push_back({ quint16(_params.StartRecord + i), _params.RecordLength, i * _params.RecordLength });
+    }
+    else
+    {
+        // the record number addresses registers, so a run splits into maximal sub-requests
+        for(int offset = 0; offset < _total; offset += maxLength)
+            _subRequests.push_back({ quint16(_params.StartRecord + offset), quint16(qMin(maxLength, _total - offset)), offset });
+    }
+
+    // pack as many sub-requests per PDU as the request and its response can hold
+    _requests.clear();
+    int first = 0;
+    while(first < _subRequests.size())
+    {
+        int requestSize = 0;
+        int responseSize = 0;
+        int registers = 0;
+        int count = 0;
+        QByteArray data;
+
+        for(int i = first; i < _subRequests.size(); i++)
+        {
+            const auto& sub = _subRequests[i];
+            if(_params.Write)
+            {
+                if(requestSize + SubRequestSize + sub.Length * 2 > MaxWriteByteCount)
+                    break;
+                requestSize += SubRequestSize + sub.Length * 2;
+            }
+            else
+            {
+                if(requestSize + SubRequestSize > MaxReadByteCount || responseSize + 2 + sub.Length * 2 > MaxReadByteCount)
+                    break;
+                requestSize += SubRequestSize;
+                responseSize += 2 + sub.Length * 2;
+            }
+
+            data.append(char(FileRecordReference));
+            appendWord(data, _params.FileNumber);
+            appendWord(data, sub.Record);
+            appendWord(data, sub.Length);
+            if(_params.Write)
+            {
+                for(int j = 0; j < sub.Length; j++)
+                    appendWord(data, _source[sub.Offset + j]);
+            }
+
+            registers += sub.Length;
+            count++;
+        }
+
+        data.prepend(char(requestSize));
+        const auto func = _params.Write ? QModbusPdu::WriteFileRecord : QModbusPdu::ReadFileRecord;
+        _requests.push_back({ QModbusRequest(func, data), first, count, registers });
+        first += count;
+    }
+}
+
+///
+/// \brief ModbusFileTransfer::sendNext
+///
+void ModbusFileTransfer::sendNext()
+{
+    // keep as many requests outstanding as the connection pipelines
+    const int window = qMax(1, _client.maxInFlight());
+    while(_inProgress && _nextRequest < _requests.size() && _sent.size() + _pending.size() < window)
+    {
+        _sent.enqueue(_nextRequest);
+        _client.sendRawRequest(_requests[_nextRequest++].Pdu, _params.DeviceId, RequestId);
+    }
+}
+
+///
+/// \brief ModbusFileTransfer::on_modbusRequest
+/// \param requestId
+/// \param deviceId
+/// \param transactionId
+/// \param request
+///
+void ModbusFileTransfer::on_modbusRequest(int requestId, int deviceId, int transactionId, const QModbusRequest& request)
+{
+    Q_UNUSED(deviceId);
+    Q_UNUSED(request);
+
+    // the client sends our requests in the order they were queued
+    if(requestId == RequestId && _inProgress && !_sent.isEmpty())
+        _pending.insert(transactionId, _sent.dequeue());
+}
+
+///
+/// \brief ModbusFileTransfer::on_modbusReply
+/// \param reply
+///
+void ModbusFileTransfer::on_modbusReply(QModbusReply* reply)
+{
+    if(!_inProgress || !reply || reply->property("RequestId").toInt() != RequestId)
+        return;
+
+    const int transactionId = reply->property("TransactionId").toInt();
+    if(!_pending.contains(transactionId))
+        return;
+
+    const int index = _pending.take(transactionId);
+    const auto& request = _requests.at(index);
+    const auto response = reply->rawResult();
+
+    if(reply->error() == QModbusDevice::ProtocolError)
+    {
+        ModbusException ex(response.exceptionCode());
+        finish(QString("%1 (%2)").arg(ex, formatUInt8Value(DataDisplayMode::Hex, ex)));
+        return;
+    }
+    else if(reply->error() != QModbusDevice::NoError)
+    {
+        finish(reply->errorString());
+        return;
+    }
+
+    const bool ok = _params.Write ? processWriteReply(response, request) : processReadReply(response, index);
+    if(!ok)
+    {
+        finish(tr("Invalid response to the record %1").arg(_subRequests[request.First].Record));
+        return;
+    }
+
+    _transferred += request.Registers;
+    emit progress();
+
+    if(_transferred >= _total)
+        finish();
+    else
+        sendNext();
+}
+
+///
+/// \brief ModbusFileTransfer::on_modbusError
+/// \param error
+/// \param requestId
+///
+void ModbusFileTransfer::on_modbusError(const QString& error, int requestId)
+{
+    if(_inProgress && requestId == RequestId)
+        finish(error);
+}
+
+///
+/// \brief ModbusFileTransfer::on_modbusDisconnected
+///
+void ModbusFileTransfer::on_modbusDisconnected()
+{
+    if(_inProgress)
+        finish(tr("Connection lost"));
+}
+
+///
+/// \brief ModbusFileTransfer::processReadReply
+/// \param response
+/// \param index
+/// \return
+///
+bool ModbusFileTransfer::processReadReply(const QModbusResponse& response, int index)
+{
+    const auto& request = _requests.at(index);
+    const auto data = response.data();
+    if(data.isEmpty() || quint8(data[0]) != data.size() - 1)
+        return false;
+
+    QVector<quint16> values;
+    values.reserve(request.Registers);
+
+    int pos = 1;
+    for(int i = request.First; i < request.First + request.Count; i++)
+    {
+        const int length = _subRequests[i].Length;
+        if(pos + 2 + length * 2 > data.size() ||
+           quint8(data[pos]) != 1 + length * 2 ||
+           quint8(data[pos + 1]) != FileRecordReference)
+        {
+            return false;
+        }
+
+        pos += 2;
+        for(int j = 0; j < length; j++, pos += 2)
+            values.push_back(quint16(quint8(data[pos]) << 8 | quint8(data[pos + 1])));
+    }
+
+    // replies may overtake each other, the file is written in order
+    _received.insert(index, values);
+    flush();
+
+    return true;
+}
+
+///
+/// \brief ModbusFileTransfer::processWriteReply
+/// \param response
+/// \param request
+/// \return
+///
+bool ModbusFileTransfer::processWriteReply(const QModbusResponse& response, const Request& request)
+{
+    // the normal response echoes the request
+    return response.data() == request.Pdu.data();
+}
+
+///
+/// \brief ModbusFileTransfer::flush
+///
+void ModbusFileTransfer::flush()
+{
+    while(_received.contains(_nextFlush))
+    {
+        const auto values = _received.take(_nextFlush++);
+        if(!_csv)
+        {
+            QByteArray data;
+            data.reserve(values.size() * 2);
+            for(auto&& v : values)
+                appendWord(data, v);
+            _file.write(data);
+            continue;
+        }
+
+        // one line per record, led by its record number
+        for(auto&& v : values)
+        {
+            _line.push_back(v);
+            if(_line.size() < _params.RecordLength)
+                continue;
+
+            const int record = _params.StartRecord + (_params.IndexedRecords ? _lineRecord : _lineRecord * _params.RecordLength);
+            QStringList fields(QString::number(record));
+            for(auto&& value : _line)
+                fields.append(QString::number(value));
+            _file.write(fields.join(';').toLatin1().append('\n'));
+
+            _line.clear();
+            _lineRecord++;
+        }
+    }
+}
+
+///
+/// \brief ModbusFileTransfer::finish
+/// \param error
+///
+void ModbusFileTransfer::finish(const QString& error)
+{
+    _error = error;
+    cancel();
+    emit finished();
+}
@@ -0,0 +1,109 @@
+#ifndef MODBUSFILETRANSFER_H
+#define MODBUSFILETRANSFER_H
+
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QQueue>
+#include <QObject>
+#include <QElapsedTimer>
+#include "modbusclient.h"
+
+///
+/// \brief The FileTransferParams struct
+///
+struct FileTransferParams
+{
+    bool Write = false;
+    quint8 DeviceId = 1;
+    quint16 FileNumber = 1;
+    quint16 StartRecord = 0;
+    quint16 RecordCount = 1;
+    quint16 RecordLength = 1;
+    bool IndexedRecords = false;
+    QString FileName;
+};
+
+///
+/// \brief The ModbusFileTransfer class reads or writes file records (FC20/FC21) between a device and a local file
+///
+class ModbusFileTransfer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int RequestId = -3;
+
+    explicit ModbusFileTransfer(ModbusClient& client, QObject* parent = nullptr);
+    ~ModbusFileTransfer() override;
+
+    void start(const FileTransferParams& params);
+    void cancel();
+
+    bool inProgress() const { return _inProgress; }
+    QString errorString() const { return _error; }
+
+    int total() const { return _total; }
+    int transferred() const { return _transferred; }
+    double throughput() const;
+
+    static int maxRecordLength(bool write);
+
+signals:
+    void progress();
+    void finished();
+
+private slots:
+    void on_modbusRequest(int requestId, int deviceId, int transactionId, const QModbusRequest& request);
+    void on_modbusReply(QModbusReply* reply);
+    void on_modbusError(const QString& error, int requestId);
+    void on_modbusDisconnected();
+
+private:
+    struct SubRequest
+    {
+        quint16 Record;
+        quint16 Length;
+        int Offset;
+    };
+
+    struct Request
+    {
+        QModbusRequest Pdu;
+        int First;
+        int Count;
+        int Registers;
+    };
+
+    QString validate() const;
+    bool loadSource();
+    void buildRequests();
+    void sendNext();
+    bool processReadReply(const QModbusResponse& response, int index);
+    bool processWriteReply(const QModbusResponse& response, const Request& request);
+    void flush();
+    void finish(const QString& error = QString());
+
+private:
+    ModbusClient& _client;
+    FileTransferParams _params;
+    bool _inProgress;
+    bool _csv;
+    int _total;
+    int _transferred;
+    int _nextRequest;
+    int _nextFlush;
+    QString _error;
+    QFile _file;
+    QVector<quint16> _source;
+    QVector<quint16> _line;
+    int _lineRecord;
+    QVector<SubRequest> _subRequests;
+    QVector<Request> _requests;
+    QQueue<int> _sent;
+    QHash<int, int> _pending;
+    QMap<int, QVector<quint16>> _received;
+    QElapsedTimer _timer;
+};
+
+#endif // MODBUSFILETRANSFER_H
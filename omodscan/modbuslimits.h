@@ -8,7 +8,13 @@ class ModbusLimits final
 public:
     static QRange<int> addressRange(bool zeroBased = false)  { return { (zeroBased ? 0 : 1), 65535 }; }
     static QRange<int> lengthRange()   { return { 1, 125   }; }
+    static QRange<int> bitsLengthRange() { return { 1, 2000 }; }
+    static QRange<int> writeLengthRange() { return { 1, 123 }; }
+    static QRange<int> writeBitsLengthRange() { return { 1, 1968 }; }
+    static QRange<int> bulkLengthRange() { return { 1, 65535 }; }
     static QRange<int> slaveRange()    { return { 1, 255   }; }
+    static QRange<int> fileNumberRange() { return { 1, 65535 }; }
+    static QRange<int> recordNumberRange() { return { 0, 9999 }; }
 };
 
 #endif // MODBUSLIMITS_H
@@ -89,7 +89,7 @@ public:
     bool isValid() const override {
         return ModbusMessage::isValid() &&
                fifoCount() <= 31 &&
-               fifoCount() == fifoValue().size();
+               fifoCount() * 2 == fifoValue().size();
     }
 
     ///
@@ -0,0 +1,108 @@
+#include "modbusregisterstore.h"
+
+///
+/// \brief ModbusRegisterStore::ModbusRegisterStore
+/// \param type
+/// \param startAddress
+/// \param valueCount
+///
+ModbusRegisterStore::ModbusRegisterStore(QModbusDataUnit::RegisterType type, int startAddress, int valueCount)
+    :_type(type)
+    ,_startAddress(startAddress)
+    ,_valueCount(valueCount)
+{
+}
+
+///
+/// \brief ModbusRegisterStore::hasValue
+/// \param index
+/// \return
+///
+bool ModbusRegisterStore::hasValue(int index) const
+{
+    const auto p = page(index);
+    if(!p) return false;
+
+    const auto offset = index % PageSize;
+    return p->Present[offset / 64] & (quint64(1) << (offset % 64));
+}
+
+///
+/// \brief ModbusRegisterStore::value
+/// \param index
+/// \return
+///
+quint16 ModbusRegisterStore::value(int index) const
+{
+    const auto p = page(index);
+    return p ? p->Values[index % PageSize] : 0;
+}
+
+///
+/// \brief ModbusRegisterStore::setValue
+/// \param index
+/// \param value
+///
+void ModbusRegisterStore::setValue(int index, quint16 value)
+{
+    if(index < 0 || index >= _valueCount)
+        return;
+
+    auto& p = _pages[index / PageSize];
+    const auto offset = index % PageSize;
+    p.Values[offset] = value;
+    p.Present[offset / 64] |= (quint64(1) << (offset % 64));
+}
+
+///
+/// \brief ModbusRegisterStore::setValues
+/// \param index
+/// \param values
+/// \return number of values stored
+///
+int ModbusRegisterStore::setValues(int index, const QVector<quint16>& values)
+{
+    if(index < 0 || index >= _valueCount)
+        return 0;
+
+    const int count = qMin(values.size(), _valueCount - index);
+
+    // look the page up once per page rather than once per value
+    int i = 0;
+    while(i < count)
+    {
+        auto& p = _pages[(index + i) / PageSize];
+        do
+        {
+            const auto offset = (index + i) % PageSize;
+            p.Values[offset] = values.at(i);
+            p.Present[offset / 64] |= (quint64(1) << (offset % 64));
+            i++;
+        }
+        while(i < count && (index + i) % PageSize != 0);
+    }
+
+    return count;
+}
+
+///
+/// \brief ModbusRegisterStore::clear
+///
+void ModbusRegisterStore::clear()
+{
+    _pages.clear();
+}
+
+///
+/// \brief ModbusRegisterStore::page
+/// \param index
+/// \return
+///
+const ModbusRegisterStore::Page* ModbusRegisterStore::page(int index) const
+{
+    if(index < 0 || index >= _valueCount)
+        return nullptr;
+
+    const auto it = _pages.constFind(index / PageSize);
+    return it == _pages.cend() ? nullptr : &it.value();
+}
@@ -0,0 +1,47 @@
+#ifndef MODBUSREGISTERSTORE_H
+#define MODBUSREGISTERSTORE_H
+
+#include <QHash>
+#include <QVector>
+#include <QModbusDataUnit>
+
+///
+/// \brief The ModbusRegisterStore class
+///
+class ModbusRegisterStore
+{
+public:
+    static const int PageSize = 256;
+
+    ModbusRegisterStore() = default;
+    explicit ModbusRegisterStore(QModbusDataUnit::RegisterType type, int startAddress, int valueCount);
+
+    QModbusDataUnit::RegisterType registerType() const { return _type; }
+    int startAddress() const { return _startAddress; }
+    int valueCount() const { return _valueCount; }
+
+    bool hasValue(int index) const;
+    quint16 value(int index) const;
+    void setValue(int index, quint16 value);
+    int setValues(int index, const QVector<quint16>& values);
+
+    int pageCount() const { return _pages.size(); }
+    void clear();
+
+private:
+    struct Page
+    {
+        quint16 Values[PageSize] = {};
+        quint64 Present[PageSize / 64] = {};
+    };
+
+    const Page* page(int index) const;
+
+private:
+    QModbusDataUnit::RegisterType _type = QModbusDataUnit::Invalid;
+    int _startAddress = 0;
+    int _valueCount = 0;
+    QHash<int, Page> _pages;
+};
+
+#endif // MODBUSREGISTERSTORE_H
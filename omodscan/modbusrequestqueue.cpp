@@ -0,0 +1,240 @@
+#include <limits>
+#include <algorithm>
+#include "modbusrequestqueue.h"
+
+///
+/// \brief NoRequestId
+///
+static const int NoRequestId = std::numeric_limits<int>::min();
+
+///
+/// \brief ModbusRequestQueue::ModbusRequestQueue
+///
+ModbusRequestQueue::ModbusRequestQueue()
+    :_activeRequestId(NoRequestId)
+    ,_lastBackgroundId(NoRequestId)
+    ,_activeCredits(ActiveWeight)
+{
+}
+
+///
+/// \brief ModbusRequestQueue::setActiveRequestId
+/// \param requestId
+///
+void ModbusRequestQueue::setActiveRequestId(int requestId)
+{
+    _activeRequestId = requestId;
+    _activeCredits = ActiveWeight;
+}
+
+///
+/// \brief ModbusRequestQueue::isEmpty
+/// \return
+///
+bool ModbusRequestQueue::isEmpty() const
+{
+    return _interactive.isEmpty() && _polls.isEmpty();
+}
+
+///
+/// \brief ModbusRequestQueue::size
+/// \return
+///
+int ModbusRequestQueue::size() const
+{
+    int size = _interactive.size();
+    for(auto&& queue : _polls)
+        size += queue.size();
+
+    return size;
+}
+
+///
+/// \brief ModbusRequestQueue::enqueue
+/// \param req
+/// \param interactive
+/// \return false if the same poll is already waiting and the request was dropped
+///
+bool ModbusRequestQueue::enqueue(const ModbusPendingRequest& req, bool interactive)
+{
+    auto pending = req;
+    pending.Queued.start();
+
+    if(interactive)
+    {
+        pending.Priority = RequestPriority::Interactive;
+        _interactive.enqueue(pending);
+        return true;
+    }
+
+    auto& queue = _polls[pending.RequestId];
+    for(auto&& r : queue)
+    {
+        // the same poll is still waiting for the bus, no need to queue it twice
+        if(r.Type == pending.Type && r.Server == pending.Server && r.Request == pending.Request)
+            return false;
+    }
+
+    queue.enqueue(pending);
+    return true;
+}
+
+///
+/// \brief ModbusRequestQueue::enqueueWrite
+/// \param priority Interactive writes go ahead of the polls, Background writes take turns with them
+///
+void ModbusRequestQueue::enqueueWrite(RequestPriority priority)
+{
+    // the values themselves wait in the write queue, here they only need one turn at a time
+    ModbusPendingRequest req;
+    req.Type = ModbusPendingRequest::Write;
+    req.RequestId = WriteRequestId;
+    req.Queued.start();
+
+    if(priority == RequestPriority::Interactive)
+    {
+        const bool queued = std::any_of(_interactive.cbegin(), _interactive.cend(), [](const ModbusPendingRequest& r) {
+            return r.RequestId == WriteRequestId;
+        });
+
+        if(!queued)
+        {
+            req.Priority = RequestPriority::Interactive;
+            _interactive.enqueue(req);
+        }
+        return;
+    }
+
+    auto& queue = _polls[WriteRequestId];
+    if(queue.isEmpty())
+        queue.enqueue(req);
+}
+
+///
+/// \brief ModbusRequestQueue::dequeue
+/// \return
+///
+ModbusPendingRequest ModbusRequestQueue::dequeue()
+{
+    if(!_interactive.isEmpty())
+    {
+        const auto req = _interactive.dequeue();
+        updateWaitStatistics(req);
+
+        return req;
+    }
+
+    const bool hasActive = _polls.contains(_activeRequestId);
+    const int backgroundId = nextBackgroundRequestId();
+
+    if(hasActive && (backgroundId == NoRequestId || _activeCredits > 0))
+    {
+        _activeCredits--;
+        return takeFirst(_activeRequestId, RequestPriority::Active);
+    }
+
+    if(backgroundId != NoRequestId)
+    {
+        _activeCredits = ActiveWeight;
+        _lastBackgroundId = backgroundId;
+        return takeFirst(backgroundId, RequestPriority::Background);
+    }
+
+    return ModbusPendingRequest();
+}
+
+///
+/// \brief ModbusRequestQueue::remove
+/// \param requestId
+///
+void ModbusRequestQueue::remove(int requestId)
+{
+    _polls.remove(requestId);
+    _interactive.erase(std::remove_if(_interactive.begin(), _interactive.end(), [requestId](const ModbusPendingRequest& req) {
+        return req.RequestId == requestId;
+    }), _interactive.end());
+}
+
+///
+/// \brief ModbusRequestQueue::clear
+///
+void ModbusRequestQueue::clear()
+{
+    _interactive.clear();
+    _polls.clear();
+    _activeCredits = ActiveWeight;
+}
+
+///
+/// \brief ModbusRequestQueue::waitStatistics
+/// \param priority
+/// \return
+///
+QueueWaitStatistics ModbusRequestQueue::waitStatistics(RequestPriority priority) const
+{
+    return _waitStatistics.value(priority);
+}
+
+///
+/// \brief ModbusRequestQueue::resetWaitStatistics
+///
+void ModbusRequestQueue::resetWaitStatistics()
+{
+    _waitStatistics.clear();
+}
+
+///
+/// \brief ModbusRequestQueue::nextBackgroundRequestId
+/// \return
+///
+int ModbusRequestQueue::nextBackgroundRequestId() const
+{
+    int first = NoRequestId;
+    for(auto it = _polls.cbegin(); it != _polls.cend(); ++it)
+    {
+        if(it.key() == _activeRequestId)
+            continue;
+
+        if(first == NoRequestId)
+            first = it.key();
+
+        if(it.key() > _lastBackgroundId)
+            return it.key();
+    }
+
+    return first;
+}
+
+///
+/// \brief ModbusRequestQueue::takeFirst
+/// \param requestId
+/// \param priority
+/// \return
+///
+ModbusPendingRequest ModbusRequestQueue::takeFirst(int requestId, RequestPriority priority)
+{
+    auto& queue = _polls[requestId];
+    auto req = queue.dequeue();
+    req.Priority = priority;
+
+    if(queue.isEmpty())
+        _polls.remove(requestId);
+
+    updateWaitStatistics(req);
+    return req;
+}
+
+///
+/// \brief ModbusRequestQueue::updateWaitStatistics
+/// \param req
+///
+void ModbusRequestQueue::updateWaitStatistics(const ModbusPendingRequest& req)
+{
+    const auto wait = req.Queued.elapsed();
+
+    auto& stat = _waitStatistics[req.Priority];
+    stat.Count++;
+    stat.Total += wait;
+    stat.Last = wait;
+    stat.Max = qMax(stat.Max, wait);
+}
@@ -0,0 +1,101 @@
+#ifndef MODBUSREQUESTQUEUE_H
+#define MODBUSREQUESTQUEUE_H
+
+#include <limits>
+#include <QMap>
+#include <QList>
+#include <QQueue>
+#include <QElapsedTimer>
+#include <QModbusRequest>
+#include <QModbusDataUnit>
+
+///
+/// \brief The RequestPriority enum
+///
+enum class RequestPriority
+{
+    Interactive = 0,
+    Active,
+    Background
+};
+
+///
+/// \brief The ModbusPendingRequest struct
+///
+struct ModbusPendingRequest
+{
+    enum RequestType
+    {
+        Read = 0,
+        Raw,
+        Write
+    };
+
+    RequestType Type = Raw;
+    int RequestId = 0;
+    QList<int> RequestIds;
+    int Server = 0;
+    QModbusRequest Request;
+    QModbusDataUnit DataUnit;
+    RequestPriority Priority = RequestPriority::Interactive;
+    QElapsedTimer Queued;
+};
+
+///
+/// \brief The QueueWaitStatistics struct
+///
+struct QueueWaitStatistics
+{
+    quint64 Count = 0;
+    qint64 Total = 0;
+    qint64 Max = 0;
+    qint64 Last = 0;
+
+    qint64 average() const {
+        return Count > 0 ? Total / (qint64)Count : 0;
+    }
+};
+
+///
+/// \brief The ModbusRequestQueue class
+///
+class ModbusRequestQueue
+{
+public:
+    static const int ActiveWeight = 4;
+
+    // keys the turns of the pending writes, it never matches a producer
+    static constexpr int WriteRequestId = std::numeric_limits<int>::max();
+
+    ModbusRequestQueue();
+
+    int activeRequestId() const { return _activeRequestId; }
+    void setActiveRequestId(int requestId);
+
+    bool isEmpty() const;
+    int size() const;
+
+    bool enqueue(const ModbusPendingRequest& req, bool interactive);
+    void enqueueWrite(RequestPriority priority);
+    ModbusPendingRequest dequeue();
+    void remove(int requestId);
+    void clear();
+
+    QueueWaitStatistics waitStatistics(RequestPriority priority) const;
+    void resetWaitStatistics();
+
+private:
+    int nextBackgroundRequestId() const;
+    ModbusPendingRequest takeFirst(int requestId, RequestPriority priority);
+    void updateWaitStatistics(const ModbusPendingRequest& req);
+
+private:
+    int _activeRequestId;
+    int _lastBackgroundId;
+    int _activeCredits;
+    QQueue<ModbusPendingRequest> _interactive;
+    QMap<int, QQueue<ModbusPendingRequest>> _polls;
+    QMap<RequestPriority, QueueWaitStatistics> _waitStatistics;
+};
+
+#endif // MODBUSREQUESTQUEUE_H
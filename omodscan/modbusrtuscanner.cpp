@@ -1,78 +1,283 @@
+#include <numeric>
+#include <QElapsedTimer>
 #include "modbusrtuscanner.h"
 
 ///
-/// \brief ModbusRtuScanner::ModbusRtuScanner
+/// \brief isDeviceResponse
+/// \param reply
+/// \return true if the reply came from the addressed device rather than a timeout or a gateway
+///
+static bool isDeviceResponse(const QModbusReply* reply)
+{
+    switch(reply->error())
+    {
+        case QModbusDevice::TimeoutError:
+        case QModbusDevice::ConnectionError:
+        case QModbusDevice::ReplyAbortedError:
+        return false;
+
+        case QModbusDevice::ProtocolError:
+            switch(reply->rawResult().exceptionCode())
+            {
+                case QModbusPdu::GatewayPathUnavailable:
+                case QModbusPdu::GatewayTargetDeviceFailedToRespond:
+                return false;
+
+                default:
+                return true;
+            }
+
+        default:
+        return true;
+    }
+}
+
+///
+/// \brief commonality
+/// \param cd
+/// \return how common the line settings are on installed devices, higher is more common
+///
+static int commonality(const ConnectionDetails& cd)
+{
+    static const QVector<int> baudRates = { 2400, 4800, 57600, 115200, 38400, 19200, 9600 };
+
+    int value = baudRates.indexOf(cd.SerialParams.BaudRate) + 1;
+    value = value * 2 + (cd.SerialParams.WordLength == QSerialPort::Data8);
+    value = value * 2 + (cd.SerialParams.Parity != QSerialPort::OddParity);
+    value = value * 2 + (cd.SerialParams.StopBits == QSerialPort::OneStop);
+    return value;
+}
+
+///
+/// \brief ModbusRtuScanWorker::ModbusRtuScanWorker
 /// \param params
+/// \param connParams
+/// \param parent
 ///
-ModbusRtuScanner::ModbusRtuScanner(const ScanParams& params, QObject* parent)
-    : ModbusScanner(parent)
+ModbusRtuScanWorker::ModbusRtuScanWorker(const ScanParams& params, const QList<ConnectionDetails>& connParams, QObject* parent)
+    : QObject(parent)
     ,_modbusClient(new QModbusRtuSerialClient(this))
     ,_params(params)
+    ,_connParams(connParams)
+    ,_idIndex(0)
+    ,_detecting(false)
+    ,_detectionRan(false)
+    ,_confirmed(false)
+    ,_finished(true)
 {
-    connect(_modbusClient, &QModbusClient::stateChanged, this, &ModbusRtuScanner::on_stateChanged);
-    connect(_modbusClient, &QModbusClient::errorOccurred, this, &ModbusRtuScanner::on_errorOccurred);
+    connect(_modbusClient, &QModbusClient::stateChanged, this, &ModbusRtuScanWorker::on_stateChanged);
+    connect(_modbusClient, &QModbusClient::errorOccurred, this, &ModbusRtuScanWorker::on_errorOccurred);
 
     auto serialPort = qobject_cast<QSerialPort*>(_modbusClient->device());
-    QObject::connect(serialPort, &QSerialPort::readyRead, this,
-    [this]()
-    {
-        emit found(*_iterator, _modbusClient->property("DeviceId").toInt(), true);
-    });
+    connect(serialPort, &QSerialPort::readyRead, this, &ModbusRtuScanWorker::on_readyRead);
 }
 
 ///
-/// \brief ModbusRtuScanner::startScan
+/// \brief ModbusRtuScanWorker::start
 ///
-void ModbusRtuScanner::startScan()
+void ModbusRtuScanWorker::start()
 {
-    ModbusScanner::startScan();
+    _confirmed = false;
+    _finished = _connParams.isEmpty();
 
-    _iterator = _params.ConnParams.cbegin();
-    connectDevice(*_iterator);
+    if(_finished)
+    {
+        emit finished();
+        return;
+    }
+
+    // with a single candidate there is nothing to detect
+    _detecting = _params.AutoDetect && _connParams.size() > 1;
+    _detectionRan = _detecting;
+    _lineActivity.fill(0, _connParams.size());
+
+    if(!_detecting)
+    {
+        startStage(_connParams, sweepDeviceIds());
+        return;
+    }
+
+    // try the settings devices usually ship with first
+    auto candidates = _connParams;
+    std::stable_sort(candidates.begin(), candidates.end(), [](const ConnectionDetails& cd1, const ConnectionDetails& cd2){
+        return commonality(cd1) > commonality(cd2);
+    });
+
+    startStage(candidates, detectDeviceIds());
 }
 
 ///
-/// \brief ModbusRtuScanner::stopScan
+/// \brief ModbusRtuScanWorker::stop
 ///
-void ModbusRtuScanner::stopScan()
+void ModbusRtuScanWorker::stop()
 {
+    _finished = true;
     _modbusClient->disconnectDevice();
-    ModbusScanner::stopScan();
 }
 
 ///
-/// \brief ModbusRtuScanner::on_errorOccurred
+/// \brief ModbusRtuScanWorker::completion
+/// \return
+///
+double ModbusRtuScanWorker::completion() const
+{
+    if(_finished || _configs.isEmpty() || _deviceIds.isEmpty())
+        return 1;
+
+    const double total = _configs.size() * _deviceIds.size();
+    const double value = (std::distance(_configs.cbegin(), _iterator) * _deviceIds.size() + _idIndex + 1) / total;
+
+    // detection and the sweep that follows it count as half of the work each,
+    // on a port that skipped detection the sweep is all of it
+    if(!_detectionRan)
+        return value;
+
+    return _detecting ? value / 2 : 0.5 + value / 2;
+}
+
+///
+/// \brief ModbusRtuScanWorker::on_errorOccurred
 /// \param error
 ///
-void ModbusRtuScanner::on_errorOccurred(QModbusDevice::Error error)
+void ModbusRtuScanWorker::on_errorOccurred(QModbusDevice::Error error)
 {
+    if(_finished)
+        return;
+
     if(error == QModbusDevice::ConnectionError &&
         _modbusClient->state() == QModbusDevice::ConnectingState)
     {
-        stopScan();
-        emit errorOccurred(_modbusClient->errorString());
+        emit errorOccurred(QString("%1: %2").arg(_iterator->SerialParams.PortName, _modbusClient->errorString()));
+        finish();
     }
 }
 
 ///
-/// \brief ModbusRtuScanner::on_stateChanged
+/// \brief ModbusRtuScanWorker::on_stateChanged
 /// \param state
 ///
-void ModbusRtuScanner::on_stateChanged(QModbusDevice::State state)
+void ModbusRtuScanWorker::on_stateChanged(QModbusDevice::State state)
 {
     if(state == QModbusDevice::ConnectedState)
-        sendRequest(_params.DeviceIds.from());
+    {
+        _idIndex = 0;
+        sendRequest();
+    }
+}
+
+///
+/// \brief ModbusRtuScanWorker::on_readyRead
+///
+void ModbusRtuScanWorker::on_readyRead()
+{
+    if(_finished)
+        return;
+
+    // while detecting, bytes that never make a valid frame only rank the candidate
+    if(_detecting)
+        _lineActivity[std::distance(_configs.cbegin(), _iterator)]++;
+    else
+        emit found(*_iterator, _modbusClient->property("DeviceId").toInt(), true);
+}
+
+///
+/// \brief ModbusRtuScanWorker::detectDeviceIds
+/// \return the few ids a freshly commissioned device most likely answers on
+///
+QVector<int> ModbusRtuScanWorker::detectDeviceIds() const
+{
+    QVector<int> ids;
+    for(auto id : { _params.DeviceIds.from(), 1, 2, 247 })
+    {
+        if(_params.DeviceIds.contains(id) && !ids.contains(id))
+            ids.push_back(id);
+    }
+
+    return ids;
+}
+
+///
+/// \brief ModbusRtuScanWorker::sweepDeviceIds
+/// \return
+///
+QVector<int> ModbusRtuScanWorker::sweepDeviceIds() const
+{
+    QVector<int> ids;
+    for(int id = _params.DeviceIds.from(); id <= _params.DeviceIds.to(); id++)
+        ids.push_back(id);
+
+    return ids;
+}
+
+///
+/// \brief ModbusRtuScanWorker::rankCandidates
+/// \return the line settings ordered by the line activity seen while detecting
+///
+QList<ConnectionDetails> ModbusRtuScanWorker::rankCandidates() const
+{
+    QVector<int> order(_configs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b){
+        return _lineActivity[a] > _lineActivity[b];
+    });
+
+    QList<ConnectionDetails> candidates;
+    for(auto i : order)
+        candidates.push_back(_configs[i]);
+
+    return candidates;
+}
+
+///
+/// \brief ModbusRtuScanWorker::startStage
+/// \param configs
+/// \param deviceIds
+///
+void ModbusRtuScanWorker::startStage(const QList<ConnectionDetails>& configs, const QVector<int>& deviceIds)
+{
+    _configs = configs;
+    _deviceIds = deviceIds;
+    _iterator = _configs.cbegin();
+    _idIndex = 0;
+
+    connectDevice(*_iterator);
+}
+
+///
+/// \brief ModbusRtuScanWorker::nextConfig
+///
+void ModbusRtuScanWorker::nextConfig()
+{
+    _iterator++;
+
+    // in auto-detect mode the first line settings a device answered on end the scan of this port
+    if(_iterator != _configs.cend() && !_confirmed)
+    {
+        connectDevice(*_iterator);
+    }
+    else if(_detecting)
+    {
+        // nobody answered on the likely ids: sweep everything, most promising candidates first
+        _detecting = false;
+        startStage(rankCandidates(), sweepDeviceIds());
+    }
+    else
+    {
+        finish();
+    }
 }
 
 ///
-/// \brief ModbusRtuScanner::connectDevice
+/// \brief ModbusRtuScanWorker::connectDevice
 /// \param cd
 ///
-void ModbusRtuScanner::connectDevice(const ConnectionDetails& cd)
+void ModbusRtuScanWorker::connectDevice(const ConnectionDetails& cd)
 {
+    // response times are learnt per line, a new baud rate starts over
+    _latency = ScanTimeoutEstimator(_params.AdaptiveTimeout ? _params.MinTimeout : _params.Timeout, _params.Timeout);
+
     _modbusClient->disconnectDevice();
     _modbusClient->setNumberOfRetries(_params.RetryOnTimeout ? 1 : 0);
-    _modbusClient->setTimeout(_params.Timeout);
     _modbusClient->setConnectionParameter(QModbusDevice::SerialPortNameParameter, cd.SerialParams.PortName);
     _modbusClient->setConnectionParameter(QModbusDevice::SerialParityParameter, cd.SerialParams.Parity);
     _modbusClient->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, cd.SerialParams.BaudRate);
@@ -82,79 +287,182 @@ void ModbusRtuScanner::connectDevice(const ConnectionDetails& cd)
 }
 
 ///
-/// \brief ModbusRtuScanner::sendRequest
-/// \param deviceId
+/// \brief ModbusRtuScanWorker::finish
 ///
-void ModbusRtuScanner::sendRequest(int deviceId)
+void ModbusRtuScanWorker::finish()
 {
-    if(!inProgress())
+    stop();
+    emit finished();
+}
+
+///
+/// \brief ModbusRtuScanWorker::sendRequest
+///
+void ModbusRtuScanWorker::sendRequest()
+{
+    if(_finished)
         return;
 
-    if(deviceId > _params.DeviceIds.to())
+    if(_idIndex >= _deviceIds.size())
     {
-        _iterator++;
-
-        if(_iterator != _params.ConnParams.end())
-            connectDevice(*_iterator);
-        else
-            stopScan();
-
+        nextConfig();
         return;
     }
 
-    const double size = _params.ConnParams.size();
-    const double addrLen = (_params.DeviceIds.to() - _params.DeviceIds.from() + 1);
-    const double total = size * addrLen;
-    const double value = std::distance(_params.ConnParams.cbegin(), _iterator) / size  + (deviceId - _params.DeviceIds.from() + 1) / total;
-    emit progress(*_iterator, deviceId, value * 100);
+    const int deviceId = _deviceIds[_idIndex];
+    emit progress(*_iterator, deviceId);
+
+    const int timeout = _latency.timeout();
+    _modbusClient->setTimeout(timeout);
+
+    QElapsedTimer timer;
+    timer.start();
 
     _modbusClient->setProperty("DeviceId", deviceId);
     if(auto reply = _modbusClient->sendRawRequest(_params.Request, deviceId))
     {
         if (!reply->isFinished())
         {
-            connect(reply, &QModbusReply::finished, this, [this, reply, deviceId]()
+            connect(reply, &QModbusReply::finished, this, [this, reply, deviceId, timer, timeout]()
                 {
+                    reply->deleteLater();
+
+                    if(_finished)
+                        return;
+
                     const auto error = reply->error();
-                    if(error != QModbusDevice::TimeoutError &&
-                        error != QModbusDevice::ConnectionError &&
-                        error != QModbusDevice::ReplyAbortedError)
+                    if(error == QModbusDevice::TimeoutError && timeout < _params.Timeout)
+                    {
+                        const int attempts = _params.RetryOnTimeout ? 2 : 1;
+                        emit timeSaved((_params.Timeout - timeout) * attempts);
+                    }
+
+                    if(isDeviceResponse(reply))
                     {
-                        if(error == QModbusDevice::ProtocolError)
+                        _latency.addSample(timer.elapsed());
+                        emit found(*_iterator, deviceId, false);
+
+                        if(_params.AutoDetect)
                         {
-                            switch(reply->rawResult().exceptionCode())
-                            {
-                                case QModbusPdu::GatewayPathUnavailable:
-                                case QModbusPdu::GatewayTargetDeviceFailedToRespond:
-                                break;
+                            _confirmed = true;
 
-                                default:
-                                    emit found(*_iterator, deviceId, false);
-                                break;
+                            // the CRC checked reply confirms these line settings, sweep them alone
+                            if(_detecting)
+                            {
+                                const auto cd = *_iterator;
+                                _detecting = false;
+                                startStage({ cd }, sweepDeviceIds());
+                                return;
                             }
                         }
-                        else
-                        {
-                            emit found(*_iterator, deviceId, false);
-                        }
                     }
-                    reply->deleteLater();
 
+                    _idIndex++;
                     if(error == QModbusDevice::TimeoutError)
-                        sendRequest(deviceId + 1);
+                        sendRequest();
                     else
-                        QTimer::singleShot(_params.Timeout, [this, deviceId] { sendRequest(deviceId + 1); });
+                        QTimer::singleShot(timeout, this, [this] { sendRequest(); });
                 },
                 Qt::QueuedConnection);
         }
         else
         {
             delete reply; // broadcast replies return immediately
-            sendRequest(deviceId + 1);
+            _idIndex++;
+            sendRequest();
         }
     }
     else
     {
-        sendRequest(deviceId + 1);
+        _idIndex++;
+        sendRequest();
+    }
+}
+
+///
+/// \brief ModbusRtuScanner::ModbusRtuScanner
+/// \param params
+///
+ModbusRtuScanner::ModbusRtuScanner(const ScanParams& params, QObject* parent)
+    : ModbusScanner(parent)
+    ,_params(params)
+{
+    // one worker per serial port; the ports are scanned side by side, line settings of a port one after another
+    QStringList portNames;
+    QHash<QString, QList<ConnectionDetails>> ports;
+    for(auto&& cd : _params.ConnParams)
+    {
+        const auto& portName = cd.SerialParams.PortName;
+        if(!ports.contains(portName))
+            portNames.append(portName);
+
+        ports[portName].append(cd);
+    }
+
+    for(auto&& portName : portNames)
+    {
+        auto worker = new ModbusRtuScanWorker(_params, ports[portName], this);
+        connect(worker, &ModbusRtuScanWorker::found, this, &ModbusScanner::found);
+        connect(worker, &ModbusRtuScanWorker::errorOccurred, this, &ModbusScanner::errorOccurred);
+        connect(worker, &ModbusRtuScanWorker::timeSaved, this, &ModbusScanner::timeSaved);
+        connect(worker, &ModbusRtuScanWorker::progress, this, &ModbusRtuScanner::on_workerProgress);
+        connect(worker, &ModbusRtuScanWorker::finished, this, &ModbusRtuScanner::on_workerFinished);
+        _workers.append(worker);
+    }
+}
+
+///
+/// \brief ModbusRtuScanner::startScan
+///
+void ModbusRtuScanner::startScan()
+{
+    ModbusScanner::startScan();
+
+    for(auto&& worker : _workers)
+        worker->start();
+}
+
+///
+/// \brief ModbusRtuScanner::stopScan
+///
+void ModbusRtuScanner::stopScan()
+{
+    for(auto&& worker : _workers)
+        worker->stop();
+
+    ModbusScanner::stopScan();
+}
+
+///
+/// \brief ModbusRtuScanner::on_workerProgress
+/// \param cd
+/// \param deviceId
+///
+void ModbusRtuScanner::on_workerProgress(const ConnectionDetails& cd, int deviceId)
+{
+    if(_params.ConnParams.isEmpty())
+        return;
+
+    double value = 0;
+    for(auto&& worker : _workers)
+        value += worker->completion() * worker->size();
+
+    emit progress(cd, deviceId, value * 100 / _params.ConnParams.size());
+}
+
+///
+/// \brief ModbusRtuScanner::on_workerFinished
+///
+void ModbusRtuScanner::on_workerFinished()
+{
+    if(!inProgress())
+        return;
+
+    for(auto&& worker : _workers)
+    {
+        if(!worker->isFinished())
+            return;
     }
+
+    stopScan();
 }
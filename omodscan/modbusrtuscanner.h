@@ -10,29 +10,82 @@
 #include <QModbusRtuSerialClient>
 #endif
 
-class ModbusRtuScanner : public ModbusScanner
+///
+/// \brief The ModbusRtuScanWorker class scans the line settings of a single serial port one after another
+///
+class ModbusRtuScanWorker : public QObject
 {
     Q_OBJECT
 public:
-    explicit ModbusRtuScanner(const ScanParams& params, QObject* parent = nullptr);
+    explicit ModbusRtuScanWorker(const ScanParams& params, const QList<ConnectionDetails>& connParams, QObject* parent = nullptr);
 
-    void startScan() override;
-    void stopScan() override;
+    void start();
+    void stop();
+
+    bool isFinished() const { return _finished; }
+    int size() const { return _connParams.size(); }
+    double completion() const;
+
+signals:
+    void found(const ConnectionDetails& cd, int deviceId, bool dubious);
+    void progress(const ConnectionDetails& cd, int deviceId);
+    void errorOccurred(const QString& error);
+    void timeSaved(quint64 msec);
+    void finished();
 
 private slots:
     void on_errorOccurred(QModbusDevice::Error error);
     void on_stateChanged(QModbusDevice::State state);
+    void on_readyRead();
 
 private:
+    QVector<int> detectDeviceIds() const;
+    QVector<int> sweepDeviceIds() const;
+    QList<ConnectionDetails> rankCandidates() const;
+
+    void startStage(const QList<ConnectionDetails>& configs, const QVector<int>& deviceIds);
+    void nextConfig();
     void connectDevice(const ConnectionDetails& params);
-    void sendRequest(int deviceId);
+    void sendRequest();
+    void finish();
 
 private:
     QModbusRtuSerialClient* _modbusClient;
 
 private:
     const ScanParams _params;
+    const QList<ConnectionDetails> _connParams;
+    QList<ConnectionDetails> _configs;
     QList<ConnectionDetails>::ConstIterator _iterator;
+    QVector<int> _deviceIds;
+    QVector<int> _lineActivity;
+    ScanTimeoutEstimator _latency;
+    int _idIndex;
+    bool _detecting;
+    bool _detectionRan;
+    bool _confirmed;
+    bool _finished;
+};
+
+///
+/// \brief The ModbusRtuScanner class
+///
+class ModbusRtuScanner : public ModbusScanner
+{
+    Q_OBJECT
+public:
+    explicit ModbusRtuScanner(const ScanParams& params, QObject* parent = nullptr);
+
+    void startScan() override;
+    void stopScan() override;
+
+private slots:
+    void on_workerProgress(const ConnectionDetails& cd, int deviceId);
+    void on_workerFinished();
+
+private:
+    const ScanParams _params;
+    QList<ModbusRtuScanWorker*> _workers;
 };
 
 #endif // MODBUSRTUSCANNER_H
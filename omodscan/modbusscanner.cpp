@@ -1,5 +1,41 @@
 #include "modbusscanner.h"
 
+///
+/// \brief ScanTimeoutEstimator::ScanTimeoutEstimator
+/// \param floor
+/// \param ceiling
+///
+ScanTimeoutEstimator::ScanTimeoutEstimator(int floor, int ceiling)
+    :_floor(qMin(floor, ceiling))
+    ,_ceiling(ceiling)
+{
+}
+
+///
+/// \brief ScanTimeoutEstimator::timeout
+/// \return the ceiling until the first response has been timed
+///
+int ScanTimeoutEstimator::timeout() const
+{
+    if(_maxRtt < 0)
+        return _ceiling;
+
+    return qBound<qint64>(_floor, _maxRtt * LatencyMultiplier, _ceiling);
+}
+
+///
+/// \brief ScanTimeoutEstimator::addSample
+/// \param rtt
+///
+void ScanTimeoutEstimator::addSample(qint64 rtt)
+{
+    // a response slower than the timeout arrived after a retry and cannot be attributed to one request
+    if(rtt > timeout())
+        return;
+
+    _maxRtt = qMax(_maxRtt, rtt);
+}
+
 ///
 /// \brief ModbusScanner::ModbusScanner
 /// \param parent
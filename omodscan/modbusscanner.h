@@ -10,11 +10,39 @@ struct ScanParams
 {
     int Timeout = 1000;
     bool RetryOnTimeout = false;
+    bool AutoDetect = false;
+    bool AdaptiveTimeout = false;
+    int MinTimeout = 50;
+    int MaxConcurrentHosts = 32;
+    int MaxProbesPerHost = 4;
+    int MaxInFlight = 128;
+    int ConnectRate = 500;
+    int MaxPendingConnects = 256;
     QRange<int> DeviceIds = {1, 10};
     QModbusRequest Request;
     QList<ConnectionDetails> ConnParams;
 };
 
+///
+/// \brief The ScanTimeoutEstimator class derives the response timeout of a host or a serial line from its observed latency
+///
+class ScanTimeoutEstimator
+{
+public:
+    static const int LatencyMultiplier = 4;
+
+    ScanTimeoutEstimator() = default;
+    explicit ScanTimeoutEstimator(int floor, int ceiling);
+
+    int timeout() const;
+    void addSample(qint64 rtt);
+
+private:
+    int _floor = 0;
+    int _ceiling = 0;
+    qint64 _maxRtt = -1;
+};
+
 ///
 /// \brief The ModbusScanner class
 ///
@@ -34,6 +62,7 @@ signals:
     void found(const ConnectionDetails& cd, int deviceId, bool dubious);
     void progress(const ConnectionDetails& cd, int deviceId, int progress);
     void errorOccurred(const QString& error);
+    void timeSaved(quint64 msec);
 
 private slots:
     void on_timeout();
@@ -1,6 +1,9 @@
 #ifndef MODBUSSIMULATIONPARAMS_H
 #define MODBUSSIMULATIONPARAMS_H
 
+#include <QString>
+#include <QPointF>
+#include <QVector>
 #include <QDataStream>
 #include "qrange.h"
 #include "enums.h"
@@ -110,6 +113,87 @@ inline QDataStream& operator >>(QDataStream& in, DecrementSimulationParams& para
     return in;
 }
 
+///
+/// \brief The WaveformSimulationParams class
+///
+struct WaveformSimulationParams
+{
+    QRange<double> Range = QRange<double>(0., 65535.);
+    quint32 Period = 10000;
+    double Phase = 0.;
+    double DutyCycle = 50.;
+    QString ProfileFile;
+    QVector<QPointF> Profile;
+};
+Q_DECLARE_METATYPE(WaveformSimulationParams)
+
+///
+/// \brief operator <<
+/// \param out
+/// \param params
+/// \return
+///
+inline QDataStream& operator <<(QDataStream& out, const WaveformSimulationParams& params)
+{
+    out << params.Range;
+    out << params.Period;
+    out << params.Phase;
+    out << params.DutyCycle;
+    out << params.ProfileFile;
+    out << params.Profile;
+    return out;
+}
+
+///
+/// \brief operator >>
+/// \param in
+/// \param params
+/// \return
+///
+inline QDataStream& operator >>(QDataStream& in, WaveformSimulationParams& params)
+{
+    in >> params.Range;
+    in >> params.Period;
+    in >> params.Phase;
+    in >> params.DutyCycle;
+    in >> params.ProfileFile;
+    in >> params.Profile;
+    return in;
+}
+
+///
+/// \brief The ExpressionSimulationParams class
+///
+struct ExpressionSimulationParams
+{
+    QString Expression;
+};
+Q_DECLARE_METATYPE(ExpressionSimulationParams)
+
+///
+/// \brief operator <<
+/// \param out
+/// \param params
+/// \return
+///
+inline QDataStream& operator <<(QDataStream& out, const ExpressionSimulationParams& params)
+{
+    out << params.Expression;
+    return out;
+}
+
+///
+/// \brief operator >>
+/// \param in
+/// \param params
+/// \return
+///
+inline QDataStream& operator >>(QDataStream& in, ExpressionSimulationParams& params)
+{
+    in >> params.Expression;
+    return in;
+}
+
 ///
 /// \brief The ModbusSimulationParams class
 ///
@@ -119,7 +203,13 @@ struct ModbusSimulationParams
     RandomSimulationParams RandomParams;
     IncrementSimulationParams IncrementParams;
     DecrementSimulationParams DecrementParams;
-    quint32 Interval = 1;
+    WaveformSimulationParams WaveformParams; // streamed separately by the form to keep older files readable
+    ExpressionSimulationParams ExpressionParams; // likewise
+    quint32 Interval = 1000;
+
+    bool isWaveform() const {
+        return Mode >= SimulationMode::Sine && Mode <= SimulationMode::Profile;
+    }
 };
 Q_DECLARE_METATYPE(ModbusSimulationParams)
 
@@ -1,3 +1,5 @@
+#include <QtMath>
+#include <QPointer>
 #include <QDateTime>
 #include <QTcpSocket>
 #include "modbustcpscanner.h"
@@ -11,7 +13,12 @@ ModbusTcpScanner::ModbusTcpScanner(const ScanParams& params, QObject *parent)
     : ModbusScanner{parent}
     ,_params(params)
     ,_processedSocketCount(0)
+    ,_doneHosts(0)
+    ,_inFlight(0)
+    ,_connectTokens(0)
 {
+    _connectTimer.setSingleShot(true);
+    connect(&_connectTimer, &QTimer::timeout, this, &ModbusTcpScanner::connectNext);
     connect(this, &ModbusTcpScanner::scanNext, this, &ModbusTcpScanner::on_scanNext);
 }
 
@@ -24,20 +31,17 @@ void ModbusTcpScanner::startScan()
 
     _connParams.clear();
     _processedSocketCount = 0;
+    _doneHosts = 0;
+    _inFlight = 0;
 
+    _hosts.clear();
     for(auto&& cd : _params.ConnParams)
-    {
-        QTcpSocket* socket = new QTcpSocket(this);
+        _hosts.enqueue(cd);
 
-        connect(socket, &QAbstractSocket::connected, this, [this, socket, cd]{
-            processSocket(socket, cd);
-        }, Qt::QueuedConnection);
-        connect(socket, &QAbstractSocket::errorOccurred, this, [this, socket, cd](QAbstractSocket::SocketError){
-            processSocket(socket, cd);
-        }, Qt::QueuedConnection);
+    _connectTokens = connectBurst();
+    _bucketTimer.start();
 
-        socket->connectToHost(cd.TcpParams.IPAddress, cd.TcpParams.ServicePort, QIODevice::ReadOnly, QAbstractSocket::IPv4Protocol);
-    }
+    connectNext();
 }
 
 ///
@@ -46,6 +50,83 @@ void ModbusTcpScanner::startScan()
 void ModbusTcpScanner::stopScan()
 {
     ModbusScanner::stopScan();
+
+    _connectTimer.stop();
+    _hosts.clear();
+
+    for(auto&& socket : _sockets)
+    {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+    _sockets.clear();
+
+    for(auto it = _sessions.cbegin(); it != _sessions.cend(); ++it)
+    {
+        it.key()->disconnectDevice();
+        it.key()->deleteLater();
+    }
+    _sessions.clear();
+    _inFlight = 0;
+}
+
+///
+/// \brief ModbusTcpScanner::connectBurst
+/// \return
+///
+double ModbusTcpScanner::connectBurst() const
+{
+    // allow up to 100 ms worth of connects to go out back to back
+    return qMax(1, _params.ConnectRate / 10);
+}
+
+///
+/// \brief ModbusTcpScanner::connectNext
+///
+void ModbusTcpScanner::connectNext()
+{
+    if(!inProgress())
+        return;
+
+    const auto elapsed = _bucketTimer.nsecsElapsed();
+    _bucketTimer.restart();
+    _connectTokens = qMin(connectBurst(), _connectTokens + elapsed * _params.ConnectRate / 1e9);
+
+    while(!_hosts.isEmpty() && _sockets.size() < _params.MaxPendingConnects && _connectTokens >= 1)
+    {
+        _connectTokens -= 1;
+        connectHost(_hosts.dequeue());
+    }
+
+    // a full window is reopened by processSocket, an empty bucket needs a wakeup
+    if(!_hosts.isEmpty() && _sockets.size() < _params.MaxPendingConnects && !_connectTimer.isActive())
+        _connectTimer.start(qMax(1, qCeil((1 - _connectTokens) * 1000 / _params.ConnectRate)));
+}
+
+///
+/// \brief ModbusTcpScanner::connectHost
+/// \param cd
+///
+void ModbusTcpScanner::connectHost(const ConnectionDetails& cd)
+{
+    auto socket = new QTcpSocket(this);
+    _sockets.insert(socket);
+
+    const QPointer<QTcpSocket> sck(socket);
+    connect(socket, &QAbstractSocket::connected, this, [this, sck, cd]{
+        if(sck) processSocket(sck, cd);
+    }, Qt::QueuedConnection);
+    connect(socket, &QAbstractSocket::errorOccurred, this, [this, sck, cd](QAbstractSocket::SocketError){
+        if(sck) processSocket(sck, cd);
+    }, Qt::QueuedConnection);
+
+    // hosts that silently drop the SYN would otherwise hold a window slot for the OS connect timeout
+    QTimer::singleShot(_params.Timeout, socket, [this, socket, cd]{
+        processSocket(socket, cd);
+    });
+
+    socket->connectToHost(cd.TcpParams.IPAddress, cd.TcpParams.ServicePort, QIODevice::ReadOnly, QAbstractSocket::IPv4Protocol);
 }
 
 ///
@@ -55,7 +136,7 @@ void ModbusTcpScanner::stopScan()
 ///
 void ModbusTcpScanner::processSocket(QTcpSocket* sck, const ConnectionDetails& cd)
 {
-    if(!inProgress())
+    if(!inProgress() || !_sockets.remove(sck))
         return;
 
     _processedSocketCount++;
@@ -64,20 +145,16 @@ void ModbusTcpScanner::processSocket(QTcpSocket* sck, const ConnectionDetails& c
         _connParams.push_back(cd);
     else
     {
-        const double value = (_processedSocketCount - _connParams.size()) * 100. / _params.ConnParams.size();
-        emit progress(cd, _params.DeviceIds.from(), value);
+        _doneHosts++;
+        updateProgress(cd, _params.DeviceIds.from());
     }
 
+    sck->disconnect(this);
+    sck->abort();
     sck->deleteLater();
 
-    if(_processedSocketCount == _params.ConnParams.size())
-    {
-        std::sort(_connParams.begin(), _connParams.end(), [](const ConnectionDetails& cd1, const ConnectionDetails& cd2){
-            return QHostAddress(cd1.TcpParams.IPAddress).toIPv4Address() < QHostAddress(cd2.TcpParams.IPAddress).toIPv4Address();
-        });
-
-        emit scanNext(QPrivateSignal());
-    }
+    connectNext();
+    emit scanNext(QPrivateSignal());
 }
 
 ///
@@ -88,10 +165,31 @@ void ModbusTcpScanner::on_scanNext(QPrivateSignal)
     if(!inProgress())
         return;
 
-    if(_connParams.isEmpty())
-        stopScan();
-    else
+    closeSessions();
+
+    while(!_connParams.isEmpty() && _sessions.size() < _params.MaxConcurrentHosts)
         connectDevice(_connParams.dequeue());
+
+    // hand out probes round-robin so that a single slow host cannot take the whole in-flight budget
+    bool sent = true;
+    while(sent && _inFlight < _params.MaxInFlight)
+    {
+        sent = false;
+        for(auto it = _sessions.begin(); it != _sessions.end() && _inFlight < _params.MaxInFlight; ++it)
+        {
+            auto& session = it.value();
+            if(it.key()->state() != QModbusDevice::ConnectedState ||
+               session.Pending >= _params.MaxProbesPerHost ||
+               session.NextDeviceId > _params.DeviceIds.to())
+                continue;
+
+            sendRequest(it.key(), session);
+            sent = true;
+        }
+    }
+
+    if(_processedSocketCount == _params.ConnParams.size() && _connParams.isEmpty() && _sessions.isEmpty())
+        stopScan();
 }
 
 ///
@@ -101,87 +199,166 @@ void ModbusTcpScanner::on_scanNext(QPrivateSignal)
 void ModbusTcpScanner::connectDevice(const ConnectionDetails& cd)
 {
     auto modbusClient = new QModbusTcpClient(this);
-    connect(modbusClient, &QModbusTcpClient::stateChanged, this, [this, modbusClient](QModbusDevice::State state){
-        if(state == QModbusDevice::ConnectedState)
-            sendRequest(modbusClient, _params.DeviceIds.from());
-        });
+    connect(modbusClient, &QModbusTcpClient::stateChanged, this, [this](QModbusDevice::State state){
+            if(state == QModbusDevice::ConnectedState || state == QModbusDevice::UnconnectedState)
+                emit scanNext(QPrivateSignal());
+        }, Qt::QueuedConnection);
+
+    HostSession session;
+    session.Details = cd;
+    session.NextDeviceId = _params.DeviceIds.from();
+    session.Latency = ScanTimeoutEstimator(_params.AdaptiveTimeout ? _params.MinTimeout : _params.Timeout, _params.Timeout);
+    _sessions.insert(modbusClient, session);
+
     modbusClient->disconnectDevice();
     modbusClient->setNumberOfRetries(_params.RetryOnTimeout ? 1 : 0);
     modbusClient->setTimeout(_params.Timeout);
-    modbusClient->setProperty("ConnectionDetails", QVariant::fromValue(cd));
     modbusClient->setConnectionParameter(QModbusDevice::NetworkAddressParameter, cd.TcpParams.IPAddress);
     modbusClient->setConnectionParameter(QModbusDevice::NetworkPortParameter, cd.TcpParams.ServicePort);
-    modbusClient->connectDevice();
+
+    if(!modbusClient->connectDevice())
+        QTimer::singleShot(0, this, [this]{ emit scanNext(QPrivateSignal()); });
 }
 
 ///
 /// \brief ModbusTcpScanner::sendRequest
-/// \param deviceId
+/// \param client
+/// \param session
 ///
-void ModbusTcpScanner::sendRequest(QModbusTcpClient* client, int deviceId)
+void ModbusTcpScanner::sendRequest(QModbusTcpClient* client, HostSession& session)
 {
-    if(!inProgress())
-        return;
+    const int deviceId = session.NextDeviceId++;
+    updateProgress(session.Details, deviceId);
 
-    if(deviceId > _params.DeviceIds.to())
+    const int timeout = session.Latency.timeout();
+    client->setTimeout(timeout);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    auto reply = client->sendRawRequest(_params.Request, deviceId);
+    if(!reply)
     {
-        client->deleteLater();
-        emit scanNext(QPrivateSignal());
+        session.Done++;
+        return;
+    }
 
+    if(reply->isFinished())
+    {
+        delete reply; // broadcast replies return immediately
+        session.Done++;
         return;
     }
 
-    const auto cd = client->property("ConnectionDetails").value<ConnectionDetails>();
-    const double curr = (deviceId - _params.DeviceIds.from() + 1) / (double)(_params.DeviceIds.to() - _params.DeviceIds.from() + 1);
-    const double total = (_processedSocketCount - _connParams.size() - 1) / (double)_params.ConnParams.size();
-    const double value = total + (1 - total) * curr / (_connParams.size() + 1);
-    emit progress(cd, deviceId, value * 100);
+    session.Pending++;
+    _inFlight++;
 
-    if(auto reply = client->sendRawRequest(_params.Request, deviceId))
+    connect(reply, &QModbusReply::finished, this, [this, client, reply, deviceId, timer, timeout]
+        {
+            processReply(client, reply, deviceId, timer.elapsed(), timeout);
+        });
+}
+
+///
+/// \brief ModbusTcpScanner::processReply
+/// \param client
+/// \param reply
+/// \param deviceId
+/// \param elapsed
+/// \param timeout
+///
+void ModbusTcpScanner::processReply(QModbusTcpClient* client, QModbusReply* reply, int deviceId, qint64 elapsed, int timeout)
+{
+    reply->deleteLater();
+
+    auto it = _sessions.find(client);
+    if(!inProgress() || it == _sessions.end())
+        return;
+
+    auto& session = it.value();
+    session.Pending--;
+    session.Done++;
+    _inFlight--;
+
+    const auto error = reply->error();
+    if(error != QModbusDevice::TimeoutError &&
+       error != QModbusDevice::ConnectionError &&
+       error != QModbusDevice::ReplyAbortedError)
     {
-        if (!reply->isFinished())
+        if(error == QModbusDevice::ProtocolError)
         {
-            connect(reply, &QModbusReply::finished, this, [this, client, reply, deviceId, cd]()
-                {
-                    const auto error = reply->error();
-                    if(error != QModbusDevice::TimeoutError &&
-                       error != QModbusDevice::ConnectionError &&
-                       error != QModbusDevice::ReplyAbortedError)
-                    {
-                        if(error == QModbusDevice::ProtocolError)
-                        {
-                            switch(reply->rawResult().exceptionCode())
-                            {
-                                case QModbusPdu::GatewayPathUnavailable:
-                                case QModbusPdu::GatewayTargetDeviceFailedToRespond:
-                                break;
-
-                                default:
-                                    emit found(cd, deviceId, false);
-                                break;
-                            }
-                        }
-                        else
-                        {
-                            emit found(cd, deviceId, false);
-                        }
-                    }
-                    reply->deleteLater();
-
-                    if(error == QModbusDevice::TimeoutError)
-                        sendRequest(client, deviceId + 1);
-                    else
-                        QTimer::singleShot(_params.Timeout, [this, client, deviceId] { sendRequest(client, deviceId + 1); });
-                });
+            switch(reply->rawResult().exceptionCode())
+            {
+                case QModbusPdu::GatewayPathUnavailable:
+                case QModbusPdu::GatewayTargetDeviceFailedToRespond:
+                break;
+
+                default:
+                    emit found(session.Details, deviceId, false);
+                break;
+            }
         }
         else
         {
-            delete reply; // broadcast replies return immediately
-            sendRequest(client, deviceId + 1);
+            emit found(session.Details, deviceId, false);
         }
+
+        session.Latency.addSample(elapsed);
     }
-    else
+    else if(error == QModbusDevice::TimeoutError && timeout < _params.Timeout)
     {
-        sendRequest(client, deviceId + 1);
+        const int attempts = _params.RetryOnTimeout ? 2 : 1;
+        emit timeSaved((_params.Timeout - timeout) * attempts);
+    }
+
+    emit scanNext(QPrivateSignal());
+}
+
+///
+/// \brief ModbusTcpScanner::closeSessions
+///
+void ModbusTcpScanner::closeSessions()
+{
+    auto it = _sessions.begin();
+    while(it != _sessions.end())
+    {
+        const auto client = it.key();
+        const auto& session = it.value();
+
+        const bool completed = session.NextDeviceId > _params.DeviceIds.to();
+        const bool dropped = client->state() == QModbusDevice::UnconnectedState;
+        if(session.Pending > 0 || (!completed && !dropped))
+        {
+            ++it;
+            continue;
+        }
+
+        // device ids left unprobed on a dropped connection count as done
+        _doneHosts++;
+        updateProgress(session.Details, _params.DeviceIds.to());
+
+        client->disconnect(this);
+        client->disconnectDevice();
+        client->deleteLater();
+        it = _sessions.erase(it);
     }
 }
+
+///
+/// \brief ModbusTcpScanner::updateProgress
+/// \param cd
+/// \param deviceId
+///
+void ModbusTcpScanner::updateProgress(const ConnectionDetails& cd, int deviceId)
+{
+    if(_params.ConnParams.isEmpty())
+        return;
+
+    const double idCount = _params.DeviceIds.to() - _params.DeviceIds.from() + 1;
+
+    double done = _doneHosts;
+    for(auto it = _sessions.cbegin(); it != _sessions.cend(); ++it)
+        done += it->Done / idCount;
+
+    emit progress(cd, deviceId, done * 100 / _params.ConnParams.size());
+}
@@ -1,7 +1,10 @@
 #ifndef MODBUSTCPSCANNER_H
 #define MODBUSTCPSCANNER_H
 
+#include <QSet>
+#include <QHash>
 #include <QQueue>
+#include <QElapsedTimer>
 #include <QTcpSocket>
 #include <QModbusTcpClient>
 #include "modbusscanner.h"
@@ -25,14 +28,37 @@ private slots:
     void on_scanNext(QPrivateSignal);
 
 private:
+    struct HostSession
+    {
+        ConnectionDetails Details;
+        int NextDeviceId = 0;
+        int Pending = 0;
+        int Done = 0;
+        ScanTimeoutEstimator Latency;
+    };
+
+    double connectBurst() const;
+    void connectNext();
+    void connectHost(const ConnectionDetails& cd);
     void processSocket(QTcpSocket* sck, const ConnectionDetails& cd);
     void connectDevice(const ConnectionDetails& params);
-    void sendRequest(QModbusTcpClient* client, int deviceId);
+    void sendRequest(QModbusTcpClient* client, HostSession& session);
+    void processReply(QModbusTcpClient* client, QModbusReply* reply, int deviceId, qint64 elapsed, int timeout);
+    void closeSessions();
+    void updateProgress(const ConnectionDetails& cd, int deviceId);
 
 private:
     const ScanParams _params;
     int _processedSocketCount;
+    int _doneHosts;
+    int _inFlight;
+    double _connectTokens;
+    QTimer _connectTimer;
+    QElapsedTimer _bucketTimer;
+    QQueue<ConnectionDetails> _hosts;
+    QSet<QTcpSocket*> _sockets;
     QQueue<ConnectionDetails> _connParams;
+    QHash<QModbusTcpClient*, HostSession> _sessions;
 };
 
 #endif // MODBUSTCPSCANNER_H
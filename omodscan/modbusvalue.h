@@ -0,0 +1,122 @@
+#ifndef MODBUSVALUE_H
+#define MODBUSVALUE_H
+
+#include <QVector>
+#include <QVariant>
+
+///
+/// \brief The ModbusValue class holds a value to write as one of the supported numeric types or as raw words
+///
+class ModbusValue
+{
+public:
+    enum Type : quint8
+    {
+        Invalid = 0,
+        Bool,
+        UInt16,
+        Int16,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+        Words
+    };
+
+    ModbusValue() : _type(Invalid) { _value.UInt64 = 0; }
+    ModbusValue(bool value) : _type(Bool) { _value.UInt64 = value; }
+    ModbusValue(quint16 value) : _type(UInt16) { _value.UInt64 = value; }
+    ModbusValue(qint16 value) : _type(Int16) { _value.Int64 = value; }
+    ModbusValue(qint32 value) : _type(Int32) { _value.Int64 = value; }
+    ModbusValue(quint32 value) : _type(UInt32) { _value.UInt64 = value; }
+    ModbusValue(qint64 value) : _type(Int64) { _value.Int64 = value; }
+    ModbusValue(quint64 value) : _type(UInt64) { _value.UInt64 = value; }
+    ModbusValue(float value) : _type(Float) { _value.Float = value; }
+    ModbusValue(double value) : _type(Double) { _value.Double = value; }
+    ModbusValue(const QVector<quint16>& words) : _type(Words), _words(words) { _value.UInt64 = 0; }
+
+    Type type() const { return _type; }
+    bool isValid() const { return _type != Invalid; }
+    bool isWords() const { return _type == Words; }
+
+    bool toBool() const { return value<quint64>() != 0; }
+    quint32 toUInt() const { return value<quint32>(); }
+    qint32 toInt() const { return value<qint32>(); }
+    qint64 toLongLong() const { return value<qint64>(); }
+    quint64 toULongLong() const { return value<quint64>(); }
+    float toFloat() const { return value<float>(); }
+    double toDouble() const { return value<double>(); }
+    const QVector<quint16>& toWords() const { return _words; }
+
+    ///
+    /// \brief value
+    /// \return the held value converted to T
+    ///
+    template<typename T>
+    T value() const
+    {
+        switch(_type)
+        {
+            case Bool:
+            case UInt16:
+            case UInt32:
+            case UInt64:
+            return static_cast<T>(_value.UInt64);
+
+            case Int16:
+            case Int32:
+            case Int64:
+            return static_cast<T>(_value.Int64);
+
+            case Float:
+            return static_cast<T>(_value.Float);
+
+            case Double:
+            return static_cast<T>(_value.Double);
+
+            default:
+            return T();
+        }
+    }
+
+    ///
+    /// \brief fromVariant converts the value of an input control, for use at the UI boundary only
+    /// \param v
+    /// \return
+    ///
+    static ModbusValue fromVariant(const QVariant& v)
+    {
+        if(v.userType() == qMetaTypeId<QVector<quint16>>())
+            return ModbusValue(v.value<QVector<quint16>>());
+
+        switch(v.userType())
+        {
+            case QMetaType::Bool:       return ModbusValue(v.toBool());
+            case QMetaType::UShort:     return ModbusValue(v.value<quint16>());
+            case QMetaType::Short:      return ModbusValue(v.value<qint16>());
+            case QMetaType::Int:        return ModbusValue(v.value<qint32>());
+            case QMetaType::UInt:       return ModbusValue(v.value<quint32>());
+            case QMetaType::LongLong:   return ModbusValue(v.value<qint64>());
+            case QMetaType::ULongLong:  return ModbusValue(v.value<quint64>());
+            case QMetaType::Float:      return ModbusValue(v.toFloat());
+            case QMetaType::Double:     return ModbusValue(v.toDouble());
+            default:                    return ModbusValue();
+        }
+    }
+
+private:
+    Type _type;
+    union
+    {
+        qint64 Int64;
+        quint64 UInt64;
+        float Float;
+        double Double;
+    } _value;
+    QVector<quint16> _words;
+};
+Q_DECLARE_METATYPE(ModbusValue)
+
+#endif // MODBUSVALUE_H
@@ -1,7 +1,7 @@
 #ifndef MODBUSWRITEPARAMS_H
 #define MODBUSWRITEPARAMS_H
 
-#include <QVariant>
+#include "modbusvalue.h"
 #include "enums.h"
 
 ///
@@ -11,7 +11,7 @@ struct ModbusWriteParams
 {
     quint32 Node;
     quint32 Address;
-    QVariant Value;
+    ModbusValue Value;
     DataDisplayMode DisplayMode;
     ByteOrder Order;
     bool ZeroBasedAddress;
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include "modbuswritequeue.h"
+
+///
+/// \brief ModbusWriteQueue::size
+/// \return number of addresses waiting to be written
+///
+int ModbusWriteQueue::size() const
+{
+    int size = 0;
+    for(auto&& t : _targets)
+        size += t.Values.size();
+
+    return size;
+}
+
+///
+/// \brief ModbusWriteQueue::contains
+/// \param priority
+/// \return true if values of the priority are waiting to be written
+///
+bool ModbusWriteQueue::contains(RequestPriority priority) const
+{
+    return std::any_of(_targets.cbegin(), _targets.cend(), [priority](const Target& t) {
+        return t.Priority == priority;
+    });
+}
+
+///
+/// \brief ModbusWriteQueue::enqueue
+/// \param server
+/// \param data
+/// \param requestId
+/// \param priority
+/// \param valueWidth points per value, a value is never split across two requests
+///
+void ModbusWriteQueue::enqueue(int server, const QModbusDataUnit& data, int requestId, RequestPriority priority, int valueWidth)
+{
+    if(data.valueCount() == 0)
+        return;
+
+    auto it = std::find_if(_targets.begin(), _targets.end(), [&](const Target& t) {
+        return t.Server == server && t.Type == data.registerType() && t.Priority == priority;
+    });
+
+    if(it == _targets.end())
+        it = _targets.insert(_targets.end(), { server, data.registerType(), priority, {} });
+
+    const quint64 write = _nextWrite++;
+    _writeRefs.insert(write, int(data.valueCount()));
+
+    for(uint i = 0; i < data.valueCount(); i++)
+    {
+        auto& values = it->Values;
+        const int addr = data.startAddress() + i;
+        const bool valueStart = (valueWidth <= 1) || (i % valueWidth == 0);
+
+        // last value wins, the write it replaces may now have nothing left to send
+        const auto pending = values.find(addr);
+        if(pending != values.end())
+        {
+            const auto replaced = pending->Write;
+            *pending = { data.value(i), requestId, write, valueStart };
+            release(replaced);
+        }
+        else
+        {
+            values.insert(addr, { data.value(i), requestId, write, valueStart });
+        }
+    }
+}
+
+///
+/// \brief ModbusWriteQueue::dequeue
+/// \param priority
+/// \param maxCount max registers per request
+/// \param maxBitsCount max coils per request
+/// \return the lowest run of adjacent values of the longest waiting device of the priority
+///
+ModbusWriteBlock ModbusWriteQueue::dequeue(RequestPriority priority, int maxCount, int maxBitsCount)
+{
+    ModbusWriteBlock block;
+
+    const auto first = std::find_if(_targets.begin(), _targets.end(), [priority](const Target& t) {
+        return t.Priority == priority;
+    });
+
+    if(first == _targets.end())
+        return block;
+
+    auto target = *first;
+    _targets.erase(first);
+    const int limit = (target.Type == QModbusDataUnit::Coils) ? maxBitsCount : maxCount;
+
+    auto it = target.Values.begin();
+    const int startAddress = it.key();
+
+    // a full run ends before the last value that does not fit, never in the middle of it
+    int count = 0;
+    int lastValueStart = 0;
+    for(auto i = target.Values.cbegin(); i != target.Values.cend() && i.key() == startAddress + count; ++i)
+    {
+        if(i->ValueStart)
+            lastValueStart = count;
+
+        if(count == limit)
+        {
+            if(!i->ValueStart && lastValueStart > 0)
+                count = lastValueStart;
+            break;
+        }
+        count++;
+    }
+
+    QVector<quint16> values;
+    QVector<quint64> writes;
+    while(values.size() < count)
+    {
+        values.push_back(it->Value);
+        if(!block.RequestIds.contains(it->RequestId))
+            block.RequestIds.push_back(it->RequestId);
+
+        if(--_writeRefs[it->Write] == 0)
+        {
+            _writeRefs.remove(it->Write);
+            writes.push_back(it->Write);
+        }
+
+        it = target.Values.erase(it);
+    }
+
+    // every write completed by this request beyond the first one is a request saved
+    if(writes.size() > 1)
+    {
+        block.Collapsed = writes.size() - 1;
+        _collapsed += block.Collapsed;
+    }
+
+    block.Server = target.Server;
+    block.DataUnit = QModbusDataUnit(target.Type, startAddress, values);
+
+    // devices take turns so that one busy device does not hold back the others
+    if(!target.Values.isEmpty())
+        _targets.push_back(target);
+
+    return block;
+}
+
+///
+/// \brief ModbusWriteQueue::remove
+/// \param requestId
+///
+void ModbusWriteQueue::remove(int requestId)
+{
+    for(auto t = _targets.begin(); t != _targets.end();)
+    {
+        for(auto it = t->Values.begin(); it != t->Values.end();)
+        {
+            if(it->RequestId != requestId)
+            {
+                ++it;
+                continue;
+            }
+
+            if(--_writeRefs[it->Write] == 0)
+                _writeRefs.remove(it->Write);
+
+            it = t->Values.erase(it);
+        }
+
+        if(t->Values.isEmpty())
+            t = _targets.erase(t);
+        else
+            ++t;
+    }
+}
+
+///
+/// \brief ModbusWriteQueue::clear
+///
+void ModbusWriteQueue::clear()
+{
+    _targets.clear();
+    _writeRefs.clear();
+}
+
+///
+/// \brief ModbusWriteQueue::release
+/// \param write
+///
+void ModbusWriteQueue::release(quint64 write)
+{
+    const auto it = _writeRefs.find(write);
+    if(it == _writeRefs.end())
+        return;
+
+    if(--it.value() == 0)
+    {
+        // every value of the write was replaced before it got to the bus
+        _writeRefs.erase(it);
+        _collapsed++;
+    }
+}
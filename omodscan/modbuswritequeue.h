@@ -0,0 +1,64 @@
+#ifndef MODBUSWRITEQUEUE_H
+#define MODBUSWRITEQUEUE_H
+
+#include <QMap>
+#include <QHash>
+#include <QList>
+#include <QModbusDataUnit>
+#include "modbusrequestqueue.h"
+
+///
+/// \brief The ModbusWriteBlock struct is a run of adjacent pending values that go out in one request
+///
+struct ModbusWriteBlock
+{
+    int Server = 0;
+    QList<int> RequestIds;
+    int Collapsed = 0;
+    QModbusDataUnit DataUnit;
+};
+
+///
+/// \brief The ModbusWriteQueue class keeps the pending writes of every device, the latest value per address
+///
+class ModbusWriteQueue
+{
+public:
+    bool isEmpty() const { return _targets.isEmpty(); }
+    bool contains(RequestPriority priority) const;
+    int size() const;
+
+    void enqueue(int server, const QModbusDataUnit& data, int requestId, RequestPriority priority, int valueWidth = 1);
+    ModbusWriteBlock dequeue(RequestPriority priority, int maxCount, int maxBitsCount);
+    void remove(int requestId);
+    void clear();
+
+    quint64 collapsed() const { return _collapsed; }
+
+private:
+    struct PendingValue
+    {
+        quint16 Value;
+        int RequestId;
+        quint64 Write;
+        bool ValueStart;
+    };
+
+    struct Target
+    {
+        int Server;
+        QModbusDataUnit::RegisterType Type;
+        RequestPriority Priority;
+        QMap<int, PendingValue> Values;
+    };
+
+    void release(quint64 write);
+
+private:
+    quint64 _nextWrite = 0;
+    quint64 _collapsed = 0;
+    QList<Target> _targets;
+    QHash<quint64, int> _writeRefs;
+};
+
+#endif // MODBUSWRITEQUEUE_H
@@ -52,9 +52,12 @@ SOURCES += \
     dialogs/dialogaddressscan.cpp \
     dialogs/dialogautosimulation.cpp \
     dialogs/dialogautostart.cpp \
+    dialogs/dialogbulkwrite.cpp \
     dialogs/dialogcoilsimulation.cpp \
     dialogs/dialogconnectiondetails.cpp \
     dialogs/dialogdisplaydefinition.cpp \
+    dialogs/dialogfiforeader.cpp \
+    dialogs/dialogfiletransfer.cpp \
     dialogs/dialogforcemultiplecoils.cpp \
     dialogs/dialogforcemultipleregisters.cpp \
     dialogs/dialogmaskwriteregiter.cpp \
@@ -62,6 +65,7 @@ SOURCES += \
     dialogs/dialogprintsettings.cpp \
     dialogs/dialogprotocolselections.cpp \
     dialogs/dialogsetuppresetdata.cpp \
+    dialogs/dialogtagview.cpp \
     dialogs/dialogusermsg.cpp \
     dialogs/dialogwindowsmanager.cpp \
     dialogs/dialogwritecoilregister.cpp \
@@ -71,17 +75,28 @@ SOURCES += \
     htmldelegate.cpp \
     main.cpp \
     mainwindow.cpp \
+    modbusbulkwriter.cpp \
     modbusclient.cpp \
-    modbusdataunit.cpp \
+    modbusdevicemonitor.cpp \
+    modbusfiforeader.cpp \
+    modbusfiletransfer.cpp \
     modbusmessages/modbusmessage.cpp \
+    modbusregisterstore.cpp \
+    modbusrequestqueue.cpp \
     modbusrtuscanner.cpp \
     modbusscanner.cpp \
     modbustcpscanner.cpp \
+    modbuswritequeue.cpp \
     qfixedsizedialog.cpp \
     qhexvalidator.cpp \
     qint64validator.cpp \
     quintvalidator.cpp \
+    readplan.cpp \
     recentfileactionlist.cpp \
+    simulationexpression.cpp \
+    tagdatabase.cpp \
+    timerwheel.cpp \
+    waveformgenerator.cpp \
     windowactionlist.cpp
 
 HEADERS += \
@@ -115,9 +130,12 @@ HEADERS += \
     dialogs/dialogaddressscan.h \
     dialogs/dialogautosimulation.h \
     dialogs/dialogautostart.h \
+    dialogs/dialogbulkwrite.h \
     dialogs/dialogcoilsimulation.h \
     dialogs/dialogconnectiondetails.h \
     dialogs/dialogdisplaydefinition.h \
+    dialogs/dialogfiforeader.h \
+    dialogs/dialogfiletransfer.h \
     dialogs/dialogforcemultiplecoils.h \
     dialogs/dialogforcemultipleregisters.h \
     dialogs/dialogmaskwriteregiter.h \
@@ -125,6 +143,7 @@ HEADERS += \
     dialogs/dialogprintsettings.h \
     dialogs/dialogprotocolselections.h \
     dialogs/dialogsetuppresetdata.h \
+    dialogs/dialogtagview.h \
     dialogs/dialogusermsg.h \
     dialogs/dialogwindowsmanager.h \
     dialogs/dialogwritecoilregister.h \
@@ -136,9 +155,12 @@ HEADERS += \
     formmodsca.h \
     htmldelegate.h \
     mainwindow.h \
+    modbusbulkwriter.h \
     modbusclient.h \
-    modbusdataunit.h \
+    modbusdevicemonitor.h \
     modbusexception.h \
+    modbusfiforeader.h \
+    modbusfiletransfer.h \
     modbusfunction.h \
     modbusmessages/diagnostics.h \
     modbusmessages/getcommeventcounter.h \
@@ -161,11 +183,15 @@ HEADERS += \
     modbusmessages/writemultipleregisters.h \
     modbusmessages/writesinglecoil.h \
     modbusmessages/writesingleregister.h \
+    modbusregisterstore.h \
+    modbusrequestqueue.h \
     modbusrtuscanner.h \
     modbusscanner.h \
     modbussimulationparams.h \
     modbustcpscanner.h \
+    modbusvalue.h \
     modbuswriteparams.h \
+    modbuswritequeue.h \
     numericutils.h \
     qfixedsizedialog.h \
     qhexvalidator.h \
@@ -175,8 +201,13 @@ HEADERS += \
     qmodbusadutcp.h \
     qrange.h \
     quintvalidator.h \
+    readplan.h \
     recentfileactionlist.h \
     serialportutils.h \
+    simulationexpression.h \
+    tagdatabase.h \
+    timerwheel.h \
+    waveformgenerator.h \
     windowactionlist.h
 
 FORMS += \
@@ -187,9 +218,12 @@ FORMS += \
     dialogs/dialogaddressscan.ui \
     dialogs/dialogautosimulation.ui \
     dialogs/dialogautostart.ui \
+    dialogs/dialogbulkwrite.ui \
     dialogs/dialogcoilsimulation.ui \
     dialogs/dialogconnectiondetails.ui \
     dialogs/dialogdisplaydefinition.ui \
+    dialogs/dialogfiforeader.ui \
+    dialogs/dialogfiletransfer.ui \
     dialogs/dialogforcemultiplecoils.ui \
     dialogs/dialogforcemultipleregisters.ui \
     dialogs/dialogmaskwriteregiter.ui \
@@ -197,6 +231,7 @@ FORMS += \
     dialogs/dialogprintsettings.ui \
     dialogs/dialogprotocolselections.ui \
     dialogs/dialogsetuppresetdata.ui \
+    dialogs/dialogtagview.ui \
     dialogs/dialogusermsg.ui \
     dialogs/dialogwindowsmanager.ui \
     dialogs/dialogwritecoilregister.ui \
@@ -0,0 +1,100 @@
+#include <numeric>
+#include <algorithm>
+#include "readplan.h"
+
+///
+/// \brief ReadPlan::compile
+/// \param db
+/// \param params
+/// \return
+///
+ReadPlan ReadPlan::compile(const TagDatabase& db, const ReadPlanParams& params)
+{
+    ReadPlan plan;
+    const auto& tags = db.tags();
+
+    QVector<int> order(tags.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&tags](int a, int b) {
+        const auto& x = tags[a];
+        const auto& y = tags[b];
+        if(x.DeviceId != y.DeviceId) return x.DeviceId < y.DeviceId;
+        if(x.Type != y.Type) return x.Type < y.Type;
+        return x.startAddress() < y.startAddress();
+    });
+
+    int covered = 0;
+    int coveredEnd = 0;
+    ReadPlanRequest* current = nullptr;
+
+    // the tags are swept in address order, a request grows while the next tag
+    // stays within the gap cost and the device's PDU; the greedy sweep gives the fewest requests.
+    // A value cannot be split, so a tag wider than the device's limit raises the limit to its own width
+    for(int i : order)
+    {
+        const auto& tag = tags[i];
+        const bool bits = tag.Type == QModbusDataUnit::Coils || tag.Type == QModbusDataUnit::DiscreteInputs;
+        const auto limits = db.deviceLimits(tag.DeviceId);
+        const int maxCount = qMax(bits ? limits.MaxBits : limits.MaxRegisters, tag.length());
+        const int maxGap = bits ? params.MaxBitsGap : params.MaxGap;
+
+        const int start = tag.startAddress();
+        const int end = qMin(start + tag.length(), 65536);
+
+        if(current != nullptr &&
+           current->DeviceId == tag.DeviceId && current->Type == tag.Type &&
+           start - (current->StartAddress + current->Count) <= maxGap &&
+           qMax<int>(end, current->StartAddress + current->Count) - current->StartAddress <= maxCount)
+        {
+            current->Count = qMax<int>(end, current->StartAddress + current->Count) - current->StartAddress;
+            current->Tags.push_back(i);
+        }
+        else
+        {
+            plan._requests.push_back({ tag.DeviceId, tag.Type, quint16(start), quint16(end - start), { i } });
+            current = &plan._requests.last();
+            coveredEnd = start;
+        }
+
+        // points read for tags, overlapping tags count once
+        covered += qMax(0, end - qMax(start, coveredEnd));
+        coveredEnd = qMax(coveredEnd, end);
+    }
+
+    plan._tagCount = tags.size();
+    for(int i = 0; i < plan._requests.size(); i++)
+    {
+        const auto& req = plan._requests[i];
+        plan._pointCount += req.Count;
+        plan._index.insert(key(req.DeviceId, req.Type, req.StartAddress, req.Count), i);
+    }
+    plan._gapCount = plan._pointCount - covered;
+
+    return plan;
+}
+
+///
+/// \brief ReadPlan::find
+/// \param deviceId
+/// \param type
+/// \param startAddress
+/// \param count
+/// \return index of the request or -1
+///
+int ReadPlan::find(quint8 deviceId, QModbusDataUnit::RegisterType type, int startAddress, int count) const
+{
+    return _index.value(key(deviceId, type, startAddress, count), -1);
+}
+
+///
+/// \brief ReadPlan::key
+/// \param deviceId
+/// \param type
+/// \param startAddress
+/// \param count
+/// \return
+///
+quint64 ReadPlan::key(quint8 deviceId, QModbusDataUnit::RegisterType type, int startAddress, int count)
+{
+    return quint64(deviceId) << 48 | quint64(type & 0xFF) << 40 | quint64(startAddress & 0xFFFF) << 16 | quint64(count & 0xFFFF);
+}
@@ -0,0 +1,58 @@
+#ifndef READPLAN_H
+#define READPLAN_H
+
+#include <QHash>
+#include <QVector>
+#include <QModbusDataUnit>
+#include "tagdatabase.h"
+
+///
+/// \brief The ReadPlanParams struct
+///
+struct ReadPlanParams
+{
+    int MaxGap = 8;
+    int MaxBitsGap = 128;
+};
+
+///
+/// \brief The ReadPlanRequest struct is a single read that covers one or more tags
+///
+struct ReadPlanRequest
+{
+    quint8 DeviceId;
+    QModbusDataUnit::RegisterType Type;
+    quint16 StartAddress;
+    quint16 Count;
+    QVector<int> Tags;
+};
+
+///
+/// \brief The ReadPlan class groups the tags of a database into the fewest read requests
+///
+class ReadPlan
+{
+public:
+    ReadPlan() = default;
+
+    static ReadPlan compile(const TagDatabase& db, const ReadPlanParams& params);
+
+    const QVector<ReadPlanRequest>& requests() const { return _requests; }
+    int find(quint8 deviceId, QModbusDataUnit::RegisterType type, int startAddress, int count) const;
+
+    int tagCount() const { return _tagCount; }
+    int pointCount() const { return _pointCount; }
+    int gapCount() const { return _gapCount; }
+
+private:
+    static quint64 key(quint8 deviceId, QModbusDataUnit::RegisterType type, int startAddress, int count);
+
+private:
+    QVector<ReadPlanRequest> _requests;
+    QHash<quint64, int> _index;
+    int _tagCount = 0;
+    int _pointCount = 0;
+    int _gapCount = 0;
+};
+
+#endif // READPLAN_H
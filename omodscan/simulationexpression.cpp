@@ -0,0 +1,576 @@
+#include <cmath>
+#include <algorithm>
+#include <QHash>
+#include "simulationexpression.h"
+
+///
+/// \brief The NestingGuard struct counts the parser recursion for as long as it is in scope
+///
+struct NestingGuard
+{
+    explicit NestingGuard(int& nesting) : _nesting(nesting) { _nesting++; }
+    ~NestingGuard() { _nesting--; }
+
+private:
+    int& _nesting;
+};
+
+///
+/// \brief SimulationExpression::compile
+/// \param text
+/// \return
+///
+bool SimulationExpression::compile(const QString& text)
+{
+    _code.clear();
+    _errorString.clear();
+    _text = text;
+    _pos = 0;
+    _nesting = 0;
+
+    if(!parseTernary())
+    {
+        _code.clear();
+        return false;
+    }
+
+    skipSpaces();
+    if(_pos < _text.size())
+    {
+        fail(tr("Unexpected '%1' at position %2").arg(_text[_pos]).arg(_pos + 1));
+        _code.clear();
+        return false;
+    }
+
+    int depth = 0, maxDepth = 0;
+    for(auto&& instr : _code)
+    {
+        depth += stackEffect(instr.Code);
+        maxDepth = qMax(maxDepth, depth);
+    }
+
+    if(maxDepth > MaxStackDepth)
+    {
+        fail(tr("Expression is too complex"));
+        _code.clear();
+        return false;
+    }
+
+    _code.squeeze();
+    _text.clear();
+    return true;
+}
+
+///
+/// \brief SimulationExpression::evaluate
+/// \param ctx
+/// \return
+///
+double SimulationExpression::evaluate(const Context& ctx) const
+{
+    double stack[MaxStackDepth];
+    int sp = 0;
+
+    for(auto&& instr : _code)
+    {
+        switch(instr.Code)
+        {
+            case OpCode::Const:
+                stack[sp++] = instr.Value;
+            break;
+
+            case OpCode::Time:
+                stack[sp++] = ctx.Time;
+            break;
+
+            case OpCode::Load:
+            {
+                const auto image = ctx.Registers[instr.Type];
+                stack[sp++] = (image && instr.Address < image->size()) ? image->at(instr.Address) : 0.;
+            }
+            break;
+
+            case OpCode::Neg:           stack[sp - 1] = -stack[sp - 1]; break;
+            case OpCode::Not:           stack[sp - 1] = stack[sp - 1] == 0.; break;
+            case OpCode::Sin:           stack[sp - 1] = std::sin(stack[sp - 1]); break;
+            case OpCode::Cos:           stack[sp - 1] = std::cos(stack[sp - 1]); break;
+            case OpCode::Tan:           stack[sp - 1] = std::tan(stack[sp - 1]); break;
+            case OpCode::Abs:           stack[sp - 1] = std::abs(stack[sp - 1]); break;
+            case OpCode::Sqrt:          stack[sp - 1] = std::sqrt(stack[sp - 1]); break;
+            case OpCode::Exp:           stack[sp - 1] = std::exp(stack[sp - 1]); break;
+            case OpCode::Log:           stack[sp - 1] = std::log(stack[sp - 1]); break;
+            case OpCode::Floor:         stack[sp - 1] = std::floor(stack[sp - 1]); break;
+            case OpCode::Ceil:          stack[sp - 1] = std::ceil(stack[sp - 1]); break;
+            case OpCode::Round:         stack[sp - 1] = std::round(stack[sp - 1]); break;
+
+            case OpCode::Add:           sp--; stack[sp - 1] = stack[sp - 1] + stack[sp]; break;
+            case OpCode::Sub:           sp--; stack[sp - 1] = stack[sp - 1] - stack[sp]; break;
+            case OpCode::Mul:           sp--; stack[sp - 1] = stack[sp - 1] * stack[sp]; break;
+            case OpCode::Div:           sp--; stack[sp - 1] = stack[sp - 1] / stack[sp]; break;
+            case OpCode::Mod:           sp--; stack[sp - 1] = std::fmod(stack[sp - 1], stack[sp]); break;
+            case OpCode::Pow:           sp--; stack[sp - 1] = std::pow(stack[sp - 1], stack[sp]); break;
+            case OpCode::Less:          sp--; stack[sp - 1] = stack[sp - 1] < stack[sp]; break;
+            case OpCode::LessEqual:     sp--; stack[sp - 1] = stack[sp - 1] <= stack[sp]; break;
+            case OpCode::Greater:       sp--; stack[sp - 1] = stack[sp - 1] > stack[sp]; break;
+            case OpCode::GreaterEqual:  sp--; stack[sp - 1] = stack[sp - 1] >= stack[sp]; break;
+            case OpCode::Equal:         sp--; stack[sp - 1] = stack[sp - 1] == stack[sp]; break;
+            case OpCode::NotEqual:      sp--; stack[sp - 1] = stack[sp - 1] != stack[sp]; break;
+            case OpCode::And:           sp--; stack[sp - 1] = stack[sp - 1] != 0. && stack[sp] != 0.; break;
+            case OpCode::Or:            sp--; stack[sp - 1] = stack[sp - 1] != 0. || stack[sp] != 0.; break;
+            case OpCode::Min:           sp--; stack[sp - 1] = std::min(stack[sp - 1], stack[sp]); break;
+            case OpCode::Max:           sp--; stack[sp - 1] = std::max(stack[sp - 1], stack[sp]); break;
+
+            case OpCode::Select:
+                // both branches are already on the stack, the condition is on top
+                sp -= 2;
+                stack[sp - 1] = stack[sp + 1] != 0. ? stack[sp - 1] : stack[sp];
+            break;
+        }
+    }
+
+    return sp > 0 ? stack[sp - 1] : 0.;
+}
+
+///
+/// \brief SimulationExpression::stackEffect
+/// \param code
+/// \return how many values the instruction leaves on the stack
+///
+int SimulationExpression::stackEffect(OpCode code)
+{
+    switch(code)
+    {
+        case OpCode::Const:
+        case OpCode::Time:
+        case OpCode::Load:
+        return 1;
+
+        case OpCode::Neg:
+        case OpCode::Not:
+        case OpCode::Sin:
+        case OpCode::Cos:
+        case OpCode::Tan:
+        case OpCode::Abs:
+        case OpCode::Sqrt:
+        case OpCode::Exp:
+        case OpCode::Log:
+        case OpCode::Floor:
+        case OpCode::Ceil:
+        case OpCode::Round:
+        return 0;
+
+        case OpCode::Select:
+        return -2;
+
+        default:
+        return -1;
+    }
+}
+
+///
+/// \brief SimulationExpression::emitCode
+/// \param code
+/// \param value
+/// \param type
+/// \param addr
+///
+void SimulationExpression::emitCode(OpCode code, double value, QModbusDataUnit::RegisterType type, quint16 addr)
+{
+    _code.push_back({ code, type, addr, value });
+}
+
+///
+/// \brief SimulationExpression::fail
+/// \param error
+/// \return
+///
+bool SimulationExpression::fail(const QString& error)
+{
+    if(_errorString.isEmpty())
+        _errorString = error;
+
+    return false;
+}
+
+///
+/// \brief SimulationExpression::skipSpaces
+///
+void SimulationExpression::skipSpaces()
+{
+    while(_pos < _text.size() && _text[_pos].isSpace())
+        _pos++;
+}
+
+///
+/// \brief SimulationExpression::accept
+/// \param token
+/// \return true and consumes the token if it is next in the text
+///
+bool SimulationExpression::accept(const char* token)
+{
+    skipSpaces();
+
+    const auto len = int(qstrlen(token));
+    if(_text.mid(_pos, len) != QLatin1String(token))
+        return false;
+
+    // keep '<' from matching the start of '<=' and so on
+    if(len == 1 && _pos + 1 < _text.size() && _text[_pos + 1] == '=' && QByteArray("<>=!").contains(token[0]))
+        return false;
+
+    _pos += len;
+    return true;
+}
+
+///
+/// \brief SimulationExpression::parseTernary
+/// \return
+///
+bool SimulationExpression::parseTernary()
+{
+    // parentheses, branches and function arguments all come back here
+    const NestingGuard guard(_nesting);
+    if(_nesting > MaxNestingDepth)
+        return fail(tr("Expression is too complex"));
+
+    const int condStart = _code.size();
+    if(!parseOr())
+        return false;
+
+    if(!accept("?"))
+        return true;
+
+    const int condEnd = _code.size();
+    if(!parseTernary())
+        return false;
+
+    if(!accept(":"))
+        return fail(tr("Expected ':' at position %1").arg(_pos + 1));
+
+    if(!parseTernary())
+        return false;
+
+    // the condition goes behind both branches so that Select finds it on top of them
+    std::rotate(_code.begin() + condStart, _code.begin() + condEnd, _code.end());
+    emitCode(OpCode::Select);
+
+    return true;
+}
+
+///
+/// \brief SimulationExpression::parseOr
+/// \return
+///
+bool SimulationExpression::parseOr()
+{
+    if(!parseAnd())
+        return false;
+
+    while(accept("||"))
+    {
+        if(!parseAnd()) return false;
+        emitCode(OpCode::Or);
+    }
+
+    return true;
+}
+
+///
+/// \brief SimulationExpression::parseAnd
+/// \return
+///
+bool SimulationExpression::parseAnd()
+{
+    if(!parseEquality())
+        return false;
+
+    while(accept("&&"))
+    {
+        if(!parseEquality()) return false;
+        emitCode(OpCode::And);
+    }
+
+    return true;
+}
+
+///
+/// \brief SimulationExpression::parseEquality
+/// \return
+///
+bool SimulationExpression::parseEquality()
+{
+    if(!parseRelational())
+        return false;
+
+    forever
+    {
+        OpCode code;
+        if(accept("==")) code = OpCode::Equal;
+        else if(accept("!=")) code = OpCode::NotEqual;
+        else break;
+
+        if(!parseRelational()) return false;
+        emitCode(code);
+    }
+
+    return true;
+}
+
+///
+/// \brief SimulationExpression::parseRelational
+/// \return
+///
+bool SimulationExpression::parseRelational()
+{
+    if(!parseAdditive())
+        return false;
+
+    forever
+    {
+        OpCode code;
+        if(accept("<=")) code = OpCode::LessEqual;
+        else if(accept(">=")) code = OpCode::GreaterEqual;
+        else if(accept("<")) code = OpCode::Less;
+        else if(accept(">")) code = OpCode::Greater;
+        else break;
+
+        if(!parseAdditive()) return false;
+        emitCode(code);
+    }
+
+    return true;
+}
+
+///
+/// \brief SimulationExpression::parseAdditive
+/// \return
+///
+bool SimulationExpression::parseAdditive()
+{
+    if(!parseMultiplicative())
+        return false;
+
+    forever
+    {
+        OpCode code;
+        if(accept("+")) code = OpCode::Add;
+        else if(accept("-")) code = OpCode::Sub;
+        else break;
+
+        if(!parseMultiplicative()) return false;
+        emitCode(code);
+    }
+
+    return true;
+}
+
+///
+/// \brief SimulationExpression::parseMultiplicative
+/// \return
+///
+bool SimulationExpression::parseMultiplicative()
+{
+    if(!parseUnary())
+        return false;
+
+    forever
+    {
+        OpCode code;
+        if(accept("*")) code = OpCode::Mul;
+        else if(accept("/")) code = OpCode::Div;
+        else if(accept("%")) code = OpCode::Mod;
+        else break;
+
+        if(!parseUnary()) return false;
+        emitCode(code);
+    }
+
+    return true;
+}
+
+///
+/// \brief SimulationExpression::parseUnary
+/// \return
+///
+bool SimulationExpression::parseUnary()
+{
+    // chained unary operators and exponents recurse without going through parseTernary
+    const NestingGuard guard(_nesting);
+    if(_nesting > MaxNestingDepth)
+        return fail(tr("Expression is too complex"));
+
+    if(accept("-"))
+    {
+        if(!parseUnary()) return false;
+        emitCode(OpCode::Neg);
+        return true;
+    }
+
+    if(accept("!"))
+    {
+        if(!parseUnary()) return false;
+        emitCode(OpCode::Not);
+        return true;
+    }
+
+    if(accept("+"))
+        return parseUnary();
+
+    return parsePower();
+}
+
+///
+/// \brief SimulationExpression::parsePower
+/// \return
+///
+bool SimulationExpression::parsePower()
+{
+    if(!parsePrimary())
+        return false;
+
+    // right associative and binds tighter than a unary minus on its left
+    if(accept("^"))
+    {
+        if(!parseUnary()) return false;
+        emitCode(OpCode::Pow);
+    }
+
+    return true;
+}
+
+///
+/// \brief SimulationExpression::parsePrimary
+/// \return
+///
+bool SimulationExpression::parsePrimary()
+{
+    skipSpaces();
+    if(_pos >= _text.size())
+        return fail(tr("Unexpected end of expression"));
+
+    if(accept("("))
+    {
+        if(!parseTernary()) return false;
+        if(!accept(")")) return fail(tr("Expected ')' at position %1").arg(_pos + 1));
+        return true;
+    }
+
+    const auto ch = _text[_pos];
+    if(ch.isDigit() || ch == '.')
+    {
+        int end = _pos;
+        while(end < _text.size() && (_text[end].isLetterOrNumber() || _text[end] == '.' ||
+              ((_text[end] == '+' || _text[end] == '-') && (_text[end - 1] == 'e' || _text[end - 1] == 'E'))))
+            end++;
+
+        bool ok;
+        const auto number = _text.mid(_pos, end - _pos);
+        const double value = number.startsWith("0x", Qt::CaseInsensitive) ? number.mid(2).toUInt(&ok, 16) : number.toDouble(&ok);
+        if(!ok)
+            return fail(tr("Invalid number '%1' at position %2").arg(number).arg(_pos + 1));
+
+        _pos = end;
+        emitCode(OpCode::Const, value);
+        return true;
+    }
+
+    if(ch.isLetter() || ch == '_')
+        return parseIdentifier();
+
+    return fail(tr("Unexpected '%1' at position %2").arg(ch).arg(_pos + 1));
+}
+
+///
+/// \brief SimulationExpression::parseIdentifier
+/// \return
+///
+bool SimulationExpression::parseIdentifier()
+{
+    const int start = _pos;
+    while(_pos < _text.size() && (_text[_pos].isLetterOrNumber() || _text[_pos] == '_'))
+        _pos++;
+
+    const auto name = _text.mid(start, _pos - start).toLower();
+
+    if(name == "t")
+    {
+        emitCode(OpCode::Time);
+        return true;
+    }
+
+    if(name == "pi")
+    {
+        emitCode(OpCode::Const, 3.141592653589793);
+        return true;
+    }
+
+    static const QHash<QString, QModbusDataUnit::RegisterType> registers = {
+        { "c", QModbusDataUnit::Coils },
+        { "coil", QModbusDataUnit::Coils },
+        { "di", QModbusDataUnit::DiscreteInputs },
+        { "ir", QModbusDataUnit::InputRegisters },
+        { "hr", QModbusDataUnit::HoldingRegisters }
+    };
+
+    if(registers.contains(name))
+    {
+        if(!accept("["))
+            return fail(tr("Expected '[' after '%1'").arg(name));
+
+        skipSpaces();
+        int end = _pos;
+        while(end < _text.size() && _text[end].isLetterOrNumber())
+            end++;
+
+        bool ok;
+        const auto number = _text.mid(_pos, end - _pos);
+        const uint addr = number.startsWith("0x", Qt::CaseInsensitive) ? number.mid(2).toUInt(&ok, 16) : number.toUInt(&ok);
+        if(!ok || addr > USHRT_MAX)
+            return fail(tr("Invalid address '%1' at position %2").arg(number).arg(_pos + 1));
+
+        _pos = end;
+        if(!accept("]"))
+            return fail(tr("Expected ']' at position %1").arg(_pos + 1));
+
+        emitCode(OpCode::Load, 0., registers[name], addr);
+        return true;
+    }
+
+    static const QHash<QString, QPair<OpCode, int>> functions = {
+        { "sin",   { OpCode::Sin, 1 } },
+        { "cos",   { OpCode::Cos, 1 } },
+        { "tan",   { OpCode::Tan, 1 } },
+        { "abs",   { OpCode::Abs, 1 } },
+        { "sqrt",  { OpCode::Sqrt, 1 } },
+        { "exp",   { OpCode::Exp, 1 } },
+        { "log",   { OpCode::Log, 1 } },
+        { "floor", { OpCode::Floor, 1 } },
+        { "ceil",  { OpCode::Ceil, 1 } },
+        { "round", { OpCode::Round, 1 } },
+        { "min",   { OpCode::Min, 2 } },
+        { "max",   { OpCode::Max, 2 } },
+        { "pow",   { OpCode::Pow, 2 } }
+    };
+
+    if(!functions.contains(name))
+        return fail(tr("Unknown name '%1' at position %2").arg(name).arg(start + 1));
+
+    const auto func = functions[name];
+    if(!accept("("))
+        return fail(tr("Expected '(' after '%1'").arg(name));
+
+    for(int i = 0; i < func.second; i++)
+    {
+        if(i > 0 && !accept(","))
+            return fail(tr("Function '%1' takes %2 arguments").arg(name).arg(func.second));
+
+        if(!parseTernary())
+            return false;
+    }
+
+    if(!accept(")"))
+        return fail(tr("Expected ')' at position %1").arg(_pos + 1));
+
+    emitCode(func.first);
+    return true;
+}
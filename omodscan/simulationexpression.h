@@ -0,0 +1,113 @@
+#ifndef SIMULATIONEXPRESSION_H
+#define SIMULATIONEXPRESSION_H
+
+#include <QVector>
+#include <QString>
+#include <QModbusDataUnit>
+#include <QCoreApplication>
+
+///
+/// \brief The SimulationExpression class compiles an expression over time and register values into stack code
+///
+/// Operands are numbers, t (seconds of simulation time), pi and register references
+/// c[addr], di[addr], ir[addr] and hr[addr] holding the latest polled values at zero-based addresses.
+/// Operators follow C precedence: ?: || && == != < <= > >= + - * / % and ^ for power.
+/// Functions: sin, cos, tan, abs, sqrt, exp, log, floor, ceil, round, min, max, pow.
+///
+class SimulationExpression
+{
+    Q_DECLARE_TR_FUNCTIONS(SimulationExpression)
+
+public:
+    static const int MaxStackDepth = 32;
+    static const int MaxNestingDepth = 64;
+
+    ///
+    /// \brief The Context struct holds the operands of one evaluation
+    ///
+    struct Context
+    {
+        double Time = 0.;
+        const QVector<quint16>* Registers[QModbusDataUnit::HoldingRegisters + 1] = {};
+    };
+
+    bool compile(const QString& text);
+    double evaluate(const Context& ctx) const;
+
+    bool isValid() const { return !_code.isEmpty(); }
+    QString errorString() const { return _errorString; }
+
+private:
+    enum class OpCode : quint8
+    {
+        Const = 0,
+        Time,
+        Load,
+        Neg,
+        Not,
+        Add,
+        Sub,
+        Mul,
+        Div,
+        Mod,
+        Pow,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        Equal,
+        NotEqual,
+        And,
+        Or,
+        Select,
+        Sin,
+        Cos,
+        Tan,
+        Abs,
+        Sqrt,
+        Exp,
+        Log,
+        Floor,
+        Ceil,
+        Round,
+        Min,
+        Max
+    };
+
+    struct Instruction
+    {
+        OpCode Code;
+        QModbusDataUnit::RegisterType Type;
+        quint16 Address;
+        double Value;
+    };
+
+    static int stackEffect(OpCode code);
+
+    void emitCode(OpCode code, double value = 0., QModbusDataUnit::RegisterType type = QModbusDataUnit::Invalid, quint16 addr = 0);
+    bool fail(const QString& error);
+
+    void skipSpaces();
+    bool accept(const char* token);
+    bool parseTernary();
+    bool parseOr();
+    bool parseAnd();
+    bool parseEquality();
+    bool parseRelational();
+    bool parseAdditive();
+    bool parseMultiplicative();
+    bool parseUnary();
+    bool parsePower();
+    bool parsePrimary();
+    bool parseIdentifier();
+
+private:
+    QVector<Instruction> _code;
+    QString _errorString;
+
+    QString _text;
+    int _pos = 0;
+    int _nesting = 0;
+};
+
+#endif // SIMULATIONEXPRESSION_H
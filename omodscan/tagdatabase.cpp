@@ -0,0 +1,502 @@
+#include <QFile>
+#include <QLocale>
+#include <QTextStream>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include "modbuslimits.h"
+#include "numericutils.h"
+#include "formatutils.h"
+#include "tagdatabase.h"
+
+///
+/// \brief ModbusTag::length
+/// \return number of points the tag occupies
+///
+int ModbusTag::length() const
+{
+    switch(Type)
+    {
+        case QModbusDataUnit::Coils:
+        case QModbusDataUnit::DiscreteInputs:
+        return 1;
+
+        default:
+        break;
+    }
+
+    switch(DataType)
+    {
+        case DataDisplayMode::FloatingPt:
+        case DataDisplayMode::SwappedFP:
+        case DataDisplayMode::Int32:
+        case DataDisplayMode::SwappedInt32:
+        case DataDisplayMode::UInt32:
+        case DataDisplayMode::SwappedUInt32:
+        return 2;
+
+        case DataDisplayMode::DblFloat:
+        case DataDisplayMode::SwappedDbl:
+        case DataDisplayMode::Int64:
+        case DataDisplayMode::SwappedInt64:
+        case DataDisplayMode::UInt64:
+        case DataDisplayMode::SwappedUInt64:
+        return 4;
+
+        default:
+        return 1;
+    }
+}
+
+///
+/// \brief ModbusTag::decode
+/// \param values the points of the tag, length() of them
+/// \return
+///
+ModbusValue ModbusTag::decode(const quint16* values) const
+{
+    if(Type == QModbusDataUnit::Coils || Type == QModbusDataUnit::DiscreteInputs)
+        return ModbusValue(values[0] != 0);
+
+    switch(DataType)
+    {
+        case DataDisplayMode::Int16:
+        return ModbusValue(qint16(toByteOrderValue(values[0], Order)));
+
+        case DataDisplayMode::FloatingPt:
+        return ModbusValue(makeFloat(values[0], values[1], Order));
+
+        case DataDisplayMode::SwappedFP:
+        return ModbusValue(makeFloat(values[1], values[0], Order));
+
+        case DataDisplayMode::DblFloat:
+        return ModbusValue(makeDouble(values[0], values[1], values[2], values[3], Order));
+
+        case DataDisplayMode::SwappedDbl:
+        return ModbusValue(makeDouble(values[3], values[2], values[1], values[0], Order));
+
+        case DataDisplayMode::Int32:
+        return ModbusValue(makeInt32(values[0], values[1], Order));
+
+        case DataDisplayMode::SwappedInt32:
+        return ModbusValue(makeInt32(values[1], values[0], Order));
+
+        case DataDisplayMode::UInt32:
+        return ModbusValue(makeUInt32(values[0], values[1], Order));
+
+        case DataDisplayMode::SwappedUInt32:
+        return ModbusValue(makeUInt32(values[1], values[0], Order));
+
+        case DataDisplayMode::Int64:
+        return ModbusValue(makeInt64(values[0], values[1], values[2], values[3], Order));
+
+        case DataDisplayMode::SwappedInt64:
+        return ModbusValue(makeInt64(values[3], values[2], values[1], values[0], Order));
+
+        case DataDisplayMode::UInt64:
+        return ModbusValue(quint64(makeUInt64(values[0], values[1], values[2], values[3], Order)));
+
+        case DataDisplayMode::SwappedUInt64:
+        return ModbusValue(quint64(makeUInt64(values[3], values[2], values[1], values[0], Order)));
+
+        default:
+        return ModbusValue(quint16(toByteOrderValue(values[0], Order)));
+    }
+}
+
+///
+/// \brief ModbusTag::format
+/// \param value
+/// \return the value with the scaling applied
+///
+QString ModbusTag::format(const ModbusValue& value) const
+{
+    switch(value.type())
+    {
+        case ModbusValue::Bool:
+        return QString("<%1>").arg(value.toBool() ? 1 : 0);
+
+        case ModbusValue::Invalid:
+        return QString();
+
+        default:
+        break;
+    }
+
+    // bit patterns are shown as they are
+    switch(DataType)
+    {
+        case DataDisplayMode::Binary:
+        return QString("%1").arg(value.value<quint16>(), 16, 2, QLatin1Char('0'));
+
+        case DataDisplayMode::Hex:
+        return formatUInt16Value(DataDisplayMode::Hex, value.value<quint16>());
+
+        default:
+        break;
+    }
+
+    if(Scale == 1. && Offset == 0.)
+    {
+        switch(value.type())
+        {
+            case ModbusValue::Float:
+            return QLocale().toString(value.toFloat());
+
+            case ModbusValue::Double:
+            return QLocale().toString(value.toDouble(), 'g', 16);
+
+            case ModbusValue::UInt64:
+            return QString::number(value.toULongLong());
+
+            default:
+            return QString::number(value.toLongLong());
+        }
+    }
+
+    return QLocale().toString(value.toDouble() * Scale + Offset);
+}
+
+///
+/// \brief TagDatabase::append
+/// \param tag
+///
+void TagDatabase::append(const ModbusTag& tag)
+{
+    _tags.push_back(tag);
+}
+
+///
+/// \brief TagDatabase::clear
+///
+void TagDatabase::clear()
+{
+    _tags.clear();
+    _devices.clear();
+}
+
+///
+/// \brief TagDatabase::deviceLimits
+/// \param deviceId
+/// \return
+///
+TagDeviceLimits TagDatabase::deviceLimits(quint8 deviceId) const
+{
+    return _devices.value(deviceId, TagDeviceLimits());
+}
+
+///
+/// \brief TagDatabase::setDeviceLimits
+/// \param deviceId
+/// \param limits
+///
+void TagDatabase::setDeviceLimits(quint8 deviceId, const TagDeviceLimits& limits)
+{
+    const auto registers = ModbusLimits::lengthRange();
+    const auto bits = ModbusLimits::bitsLengthRange();
+    _devices[deviceId] = { qBound(registers.from(), limits.MaxRegisters, registers.to()),
+                           qBound(bits.from(), limits.MaxBits, bits.to()) };
+}
+
+///
+/// \brief TagDatabase::typeName
+/// \param type
+/// \return
+///
+QString TagDatabase::typeName(QModbusDataUnit::RegisterType type)
+{
+    switch(type)
+    {
+        case QModbusDataUnit::Coils:            return "Coils";
+        case QModbusDataUnit::DiscreteInputs:   return "DiscreteInputs";
+        case QModbusDataUnit::InputRegisters:   return "InputRegisters";
+        case QModbusDataUnit::HoldingRegisters: return "HoldingRegisters";
+        default:                                return QString();
+    }
+}
+
+///
+/// \brief TagDatabase::dataTypeName
+/// \param mode
+/// \return
+///
+QString TagDatabase::dataTypeName(DataDisplayMode mode)
+{
+    switch(mode)
+    {
+        case DataDisplayMode::Binary:        return "Binary";
+        case DataDisplayMode::UInt16:        return "UInt16";
+        case DataDisplayMode::Int16:         return "Int16";
+        case DataDisplayMode::Hex:           return "Hex";
+        case DataDisplayMode::FloatingPt:    return "Float";
+        case DataDisplayMode::SwappedFP:     return "SwappedFloat";
+        case DataDisplayMode::DblFloat:      return "Double";
+        case DataDisplayMode::SwappedDbl:    return "SwappedDouble";
+        case DataDisplayMode::Int32:         return "Int32";
+        case DataDisplayMode::SwappedInt32:  return "SwappedInt32";
+        case DataDisplayMode::UInt32:        return "UInt32";
+        case DataDisplayMode::SwappedUInt32: return "SwappedUInt32";
+        case DataDisplayMode::Int64:         return "Int64";
+        case DataDisplayMode::SwappedInt64:  return "SwappedInt64";
+        case DataDisplayMode::UInt64:        return "UInt64";
+        case DataDisplayMode::SwappedUInt64: return "SwappedUInt64";
+    }
+
+    return QString();
+}
+
+///
+/// \brief parseType
+/// \param s
+/// \param ok
+/// \return
+///
+static QModbusDataUnit::RegisterType parseType(const QString& s, bool& ok)
+{
+    const auto name = s.trimmed().toLower();
+    ok = true;
+
+    if(name.isEmpty() || name == "holdingregisters" || name == "hr" || name == "4x")
+        return QModbusDataUnit::HoldingRegisters;
+    if(name == "inputregisters" || name == "ir" || name == "3x")
+        return QModbusDataUnit::InputRegisters;
+    if(name == "discreteinputs" || name == "di" || name == "1x")
+        return QModbusDataUnit::DiscreteInputs;
+    if(name == "coils" || name == "co" || name == "0x")
+        return QModbusDataUnit::Coils;
+
+    ok = false;
+    return QModbusDataUnit::Invalid;
+}
+
+///
+/// \brief parseDataType
+/// \param s
+/// \param ok
+/// \return
+///
+static DataDisplayMode parseDataType(const QString& s, bool& ok)
+{
+    const auto name = s.trimmed();
+    ok = true;
+
+    if(name.isEmpty())
+        return DataDisplayMode::UInt16;
+
+    for(int i = (int)DataDisplayMode::Binary; i <= (int)DataDisplayMode::SwappedUInt64; i++)
+    {
+        if(name.compare(TagDatabase::dataTypeName((DataDisplayMode)i), Qt::CaseInsensitive) == 0)
+            return (DataDisplayMode)i;
+    }
+
+    ok = false;
+    return DataDisplayMode::UInt16;
+}
+
+///
+/// \brief parseByteOrder
+/// \param s
+/// \return
+///
+static ByteOrder parseByteOrder(const QString& s)
+{
+    return s.trimmed().startsWith("big", Qt::CaseInsensitive) ? ByteOrder::BigEndian : ByteOrder::LittleEndian;
+}
+
+///
+/// \brief isValidLocation
+/// \param deviceId
+/// \param address one-based address of the first point
+/// \param length points the tag occupies
+/// \return true if the tag fits the Modbus device and address ranges
+///
+static bool isValidLocation(int deviceId, int address, int length)
+{
+    return ModbusLimits::slaveRange().contains(deviceId) &&
+           ModbusLimits::addressRange().contains(address) &&
+           ModbusLimits::addressRange().contains(address + length - 1);
+}
+
+///
+/// \brief TagDatabase::load
+/// \param filename
+/// \return
+///
+bool TagDatabase::load(const QString& filename)
+{
+    QFile file(filename);
+    if(!file.open(QFile::ReadOnly))
+    {
+        _error = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const auto doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if(doc.isNull())
+    {
+        _error = parseError.errorString();
+        return false;
+    }
+
+    clear();
+
+    const auto root = doc.object();
+    for(auto&& v : root.value("devices").toArray())
+    {
+        const auto obj = v.toObject();
+        const int deviceId = obj.value("id").toInt(-1);
+        if(!ModbusLimits::slaveRange().contains(deviceId))
+        {
+            _error = tr("Invalid device id %1").arg(obj.value("id").toVariant().toString());
+            clear();
+            return false;
+        }
+
+        setDeviceLimits(deviceId, { obj.value("maxRegisters").toInt(TagDeviceLimits().MaxRegisters),
+                                    obj.value("maxBits").toInt(TagDeviceLimits().MaxBits) });
+    }
+
+    for(auto&& v : root.value("tags").toArray())
+    {
+        const auto obj = v.toObject();
+
+        bool okType, okDataType;
+        ModbusTag tag;
+        tag.Name = obj.value("name").toString();
+        tag.Type = parseType(obj.value("type").toString(), okType);
+        tag.DataType = parseDataType(obj.value("dataType").toString(), okDataType);
+        tag.Order = parseByteOrder(obj.value("byteOrder").toString());
+        tag.Scale = obj.value("scale").toDouble(1.);
+        tag.Offset = obj.value("offset").toDouble(0.);
+
+        if(!okType || !okDataType)
+        {
+            _error = tr("Invalid type of the tag '%1'").arg(tag.Name);
+            clear();
+            return false;
+        }
+
+        // a non-integer or missing value fails the range check as well
+        const int deviceId = obj.value("device").toInt(1);
+        const int address = obj.value("address").toInt(-1);
+        if(!isValidLocation(deviceId, address, tag.length()))
+        {
+            _error = tr("Invalid device or address of the tag '%1'").arg(tag.Name);
+            clear();
+            return false;
+        }
+
+        tag.DeviceId = quint8(deviceId);
+        tag.Address = quint16(address);
+        append(tag);
+    }
+
+    return true;
+}
+
+///
+/// \brief TagDatabase::save
+/// \param filename
+/// \return
+///
+bool TagDatabase::save(const QString& filename) const
+{
+    QJsonArray devices;
+    for(auto it = _devices.cbegin(); it != _devices.cend(); ++it)
+    {
+        devices.append(QJsonObject{ { "id", it.key() },
+                                    { "maxRegisters", it->MaxRegisters },
+                                    { "maxBits", it->MaxBits } });
+    }
+
+    QJsonArray tags;
+    for(auto&& tag : _tags)
+    {
+        tags.append(QJsonObject{ { "name", tag.Name },
+                                 { "device", tag.DeviceId },
+                                 { "type", typeName(tag.Type) },
+                                 { "address", tag.Address },
+                                 { "dataType", dataTypeName(tag.DataType) },
+                                 { "byteOrder", tag.Order == ByteOrder::BigEndian ? "BigEndian" : "LittleEndian" },
+                                 { "scale", tag.Scale },
+                                 { "offset", tag.Offset } });
+    }
+
+    QFile file(filename);
+    if(!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        _error = file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(QJsonObject{ { "devices", devices }, { "tags", tags } }).toJson());
+    return true;
+}
+
+///
+/// \brief TagDatabase::importCsv
+/// \param filename
+/// \return
+///
+bool TagDatabase::importCsv(const QString& filename)
+{
+    QFile file(filename);
+    if(!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        _error = file.errorString();
+        return false;
+    }
+
+    // Name;Device;Type;Address;DataType;ByteOrder;Scale;Offset, an optional header line is skipped
+    const QRegularExpression separator("[,;\\t]");
+    QVector<ModbusTag> tags;
+    QTextStream s(&file);
+
+    for(int line = 1; !s.atEnd(); line++)
+    {
+        const auto text = s.readLine().trimmed();
+        if(text.isEmpty() || text.startsWith('#'))
+            continue;
+
+        const auto fields = text.split(separator);
+        const auto field = [&fields](int i) { return i < fields.size() ? fields[i].trimmed() : QString(); };
+
+        bool okDevice, okAddress, okType, okDataType;
+        bool okScale = true, okOffset = true;
+        const uint deviceId = field(1).toUInt(&okDevice);
+        const uint address = field(3).startsWith("0x", Qt::CaseInsensitive) ? field(3).mid(2).toUInt(&okAddress, 16) : field(3).toUInt(&okAddress, 10);
+
+        ModbusTag tag;
+        tag.Name = field(0);
+        tag.Type = parseType(field(2), okType);
+        tag.DataType = parseDataType(field(4), okDataType);
+        tag.Order = parseByteOrder(field(5));
+        tag.Scale = field(6).isEmpty() ? 1. : field(6).toDouble(&okScale);
+        tag.Offset = field(7).isEmpty() ? 0. : field(7).toDouble(&okOffset);
+
+        if(!okDevice || !okAddress)
+        {
+            if(line == 1) continue;
+
+            _error = tr("Invalid device or address at line %1").arg(line);
+            return false;
+        }
+
+        // range checks run before the values are narrowed to the tag fields
+        if(!okType || !okDataType || !okScale || !okOffset ||
+           !isValidLocation(int(deviceId), int(address), tag.length()))
+        {
+            _error = tr("Invalid tag at line %1").arg(line);
+            return false;
+        }
+
+        tag.DeviceId = quint8(deviceId);
+        tag.Address = quint16(address);
+        tags.push_back(tag);
+    }
+
+    _tags += tags;
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef TAGDATABASE_H
+#define TAGDATABASE_H
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <QCoreApplication>
+#include <QModbusDataUnit>
+#include "modbusvalue.h"
+#include "enums.h"
+
+///
+/// \brief The ModbusTag struct
+///
+struct ModbusTag
+{
+    QString Name;
+    quint8 DeviceId = 1;
+    QModbusDataUnit::RegisterType Type = QModbusDataUnit::HoldingRegisters;
+    quint16 Address = 1;
+    DataDisplayMode DataType = DataDisplayMode::UInt16;
+    ByteOrder Order = ByteOrder::LittleEndian;
+    double Scale = 1.;
+    double Offset = 0.;
+
+    ///
+    /// \brief startAddress
+    /// \return the protocol (zero-based) address
+    ///
+    quint16 startAddress() const {
+        return Address - 1;
+    }
+
+    int length() const;
+    ModbusValue decode(const quint16* values) const;
+    QString format(const ModbusValue& value) const;
+};
+
+///
+/// \brief The TagDeviceLimits struct
+///
+struct TagDeviceLimits
+{
+    int MaxRegisters = 125;
+    int MaxBits = 2000;
+};
+
+///
+/// \brief The TagDatabase class holds the tags of an installation and the request limits of its devices
+///
+class TagDatabase
+{
+    Q_DECLARE_TR_FUNCTIONS(TagDatabase)
+
+public:
+    TagDatabase() = default;
+
+    bool isEmpty() const { return _tags.isEmpty(); }
+    int size() const { return _tags.size(); }
+
+    const QVector<ModbusTag>& tags() const { return _tags; }
+    const ModbusTag& at(int i) const { return _tags.at(i); }
+
+    void append(const ModbusTag& tag);
+    void clear();
+
+    TagDeviceLimits deviceLimits(quint8 deviceId) const;
+    void setDeviceLimits(quint8 deviceId, const TagDeviceLimits& limits);
+    const QMap<quint8, TagDeviceLimits>& devices() const { return _devices; }
+
+    bool load(const QString& filename);
+    bool save(const QString& filename) const;
+    bool importCsv(const QString& filename);
+
+    QString errorString() const { return _error; }
+
+    static QString typeName(QModbusDataUnit::RegisterType type);
+    static QString dataTypeName(DataDisplayMode mode);
+
+private:
+    QVector<ModbusTag> _tags;
+    QMap<quint8, TagDeviceLimits> _devices;
+    mutable QString _error;
+};
+
+#endif // TAGDATABASE_H
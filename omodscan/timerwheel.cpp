@@ -0,0 +1,120 @@
+#include "timerwheel.h"
+
+///
+/// \brief levelShift
+/// \param level
+/// \return the tick bit the slots of the level start at
+///
+static int levelShift(int level)
+{
+    return level == 0 ? 0 : TimerWheel::RootBits + (level - 1) * TimerWheel::LevelBits;
+}
+
+///
+/// \brief levelSize
+/// \param level
+/// \return
+///
+static int levelSize(int level)
+{
+    return 1 << (level == 0 ? TimerWheel::RootBits : TimerWheel::LevelBits);
+}
+
+///
+/// \brief TimerWheel::TimerWheel
+///
+TimerWheel::TimerWheel()
+    :_currentTick(0)
+{
+    for(int level = 0; level < Levels; level++)
+        _slots[level].resize(levelSize(level));
+}
+
+///
+/// \brief TimerWheel::maxDelay
+/// \return the longest delay in ticks the wheel can hold, longer ones are clamped
+///
+quint64 TimerWheel::maxDelay() const
+{
+    return (quint64(1) << (RootBits + (Levels - 1) * LevelBits)) - 1;
+}
+
+///
+/// \brief TimerWheel::schedule
+/// \param id
+/// \param dueTick
+///
+void TimerWheel::schedule(int id, quint64 dueTick)
+{
+    dueTick = qBound(_currentTick + 1, dueTick, _currentTick + maxDelay());
+    insert({ id, dueTick });
+}
+
+///
+/// \brief TimerWheel::advance
+/// \param expired receives the ids that fall due on the next tick
+///
+void TimerWheel::advance(QVector<int>& expired)
+{
+    _currentTick++;
+
+    // once the root wheel wraps, pull the next slot of the outer wheels in
+    if((_currentTick & (levelSize(0) - 1)) == 0)
+    {
+        for(int level = 1; level < Levels; level++)
+        {
+            cascade(level);
+            if(((_currentTick >> levelShift(level)) & (levelSize(level) - 1)) != 0)
+                break;
+        }
+    }
+
+    auto& slot = _slots[0][_currentTick & (levelSize(0) - 1)];
+    for(auto&& e : slot)
+        expired.push_back(e.Id);
+
+    slot.resize(0);
+}
+
+///
+/// \brief TimerWheel::clear
+///
+void TimerWheel::clear()
+{
+    for(int level = 0; level < Levels; level++)
+    {
+        for(auto&& slot : _slots[level])
+            slot.clear();
+    }
+}
+
+///
+/// \brief TimerWheel::insert
+/// \param e
+///
+void TimerWheel::insert(const Entry& e)
+{
+    const quint64 delay = e.DueTick - _currentTick;
+
+    int level = 0;
+    while(level < Levels - 1 && delay >= (quint64(1) << levelShift(level + 1)))
+        level++;
+
+    const int index = (e.DueTick >> levelShift(level)) & (levelSize(level) - 1);
+    _slots[level][index].push_back(e);
+}
+
+///
+/// \brief TimerWheel::cascade
+/// \param level
+///
+void TimerWheel::cascade(int level)
+{
+    const int index = (_currentTick >> levelShift(level)) & (levelSize(level) - 1);
+
+    QVector<Entry> entries;
+    entries.swap(_slots[level][index]);
+
+    for(auto&& e : entries)
+        insert(e);
+}
@@ -0,0 +1,40 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QVector>
+
+///
+/// \brief The TimerWheel class is a hierarchical timing wheel keyed by integer ids
+///
+class TimerWheel
+{
+public:
+    static const int RootBits = 8;
+    static const int LevelBits = 6;
+    static const int Levels = 4;
+
+    TimerWheel();
+
+    quint64 currentTick() const { return _currentTick; }
+    quint64 maxDelay() const;
+
+    void schedule(int id, quint64 dueTick);
+    void advance(QVector<int>& expired);
+    void clear();
+
+private:
+    struct Entry
+    {
+        int Id;
+        quint64 DueTick;
+    };
+
+    void insert(const Entry& e);
+    void cascade(int level);
+
+private:
+    quint64 _currentTick;
+    QVector<QVector<Entry>> _slots[Levels];
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,250 @@
+#include <cmath>
+#include <algorithm>
+#include <QFile>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QRandomGenerator>
+#include "waveformgenerator.h"
+
+static const double TwoPi = 6.283185307179586;
+
+///
+/// \brief WaveformGenerator::add
+/// \param tag
+/// \param mode
+/// \param params
+/// \param time simulation time in msec, shared by every point so that phases stay aligned
+///
+void WaveformGenerator::add(int tag, SimulationMode mode, const WaveformSimulationParams& params, quint64 time)
+{
+    const int shape = int(mode) - int(SimulationMode::Sine);
+    if(shape < 0 || shape >= Shapes)
+        return;
+
+    auto& batch = _batches[shape];
+    batch.Tags.push_back(tag);
+    batch.Lows.push_back(params.Range.from());
+    batch.Spans.push_back(params.Range.to() - params.Range.from());
+    batch.Shapes.push_back(qBound(0.01, params.DutyCycle / 100., 1.));
+
+    if(mode == SimulationMode::Profile)
+    {
+        const double duration = params.Profile.isEmpty() ? 0. : params.Profile.last().x();
+        const double position = duration > 0 ? std::fmod(time + params.Phase / 360. * duration, duration) : 0.;
+        batch.Positions.push_back(position < 0 ? position + duration : position);
+        batch.Profiles.push_back(&params.Profile);
+    }
+    else
+    {
+        const double period = qMax<quint32>(1, params.Period);
+        const double position = std::fmod(time / period + params.Phase / 360., 1.);
+        batch.Positions.push_back(position < 0 ? position + 1. : position);
+        batch.Profiles.push_back(nullptr);
+    }
+}
+
+///
+/// \brief WaveformGenerator::generate
+///
+void WaveformGenerator::generate()
+{
+    for(int shape = 0; shape < Shapes; shape++)
+    {
+        auto& batch = _batches[shape];
+        if(batch.Tags.isEmpty())
+            continue;
+
+        batch.Values.resize(batch.Tags.size());
+        switch(SimulationMode(shape + int(SimulationMode::Sine)))
+        {
+            case SimulationMode::Sine:
+                sine(batch);
+            break;
+
+            case SimulationMode::Triangle:
+                triangle(batch);
+            break;
+
+            case SimulationMode::Square:
+                square(batch);
+            break;
+
+            case SimulationMode::Ramp:
+                ramp(batch);
+            break;
+
+            case SimulationMode::Noise:
+                noise(batch);
+            break;
+
+            case SimulationMode::Profile:
+                profile(batch);
+            break;
+
+            default:
+            break;
+        }
+    }
+}
+
+///
+/// \brief WaveformGenerator::clear
+///
+void WaveformGenerator::clear()
+{
+    // the columns keep their capacity from tick to tick
+    for(auto&& batch : _batches)
+    {
+        batch.Tags.resize(0);
+        batch.Positions.resize(0);
+        batch.Lows.resize(0);
+        batch.Spans.resize(0);
+        batch.Shapes.resize(0);
+        batch.Profiles.resize(0);
+        batch.Values.resize(0);
+    }
+}
+
+///
+/// \brief WaveformGenerator::sine
+/// \param batch
+///
+void WaveformGenerator::sine(Batch& batch) const
+{
+    const int size = batch.Tags.size();
+    for(int i = 0; i < size; i++)
+        batch.Values[i] = batch.Lows[i] + batch.Spans[i] * (0.5 + 0.5 * std::sin(TwoPi * batch.Positions[i]));
+}
+
+///
+/// \brief WaveformGenerator::triangle
+/// \param batch
+///
+void WaveformGenerator::triangle(Batch& batch) const
+{
+    const int size = batch.Tags.size();
+    for(int i = 0; i < size; i++)
+        batch.Values[i] = batch.Lows[i] + batch.Spans[i] * (1. - std::abs(2. * batch.Positions[i] - 1.));
+}
+
+///
+/// \brief WaveformGenerator::square
+/// \param batch
+///
+void WaveformGenerator::square(Batch& batch) const
+{
+    const int size = batch.Tags.size();
+    for(int i = 0; i < size; i++)
+        batch.Values[i] = batch.Lows[i] + (batch.Positions[i] < batch.Shapes[i] ? batch.Spans[i] : 0.);
+}
+
+///
+/// \brief WaveformGenerator::ramp
+/// \param batch
+///
+void WaveformGenerator::ramp(Batch& batch) const
+{
+    // rises over the duty part of the period and holds the high limit for the rest of it
+    const int size = batch.Tags.size();
+    for(int i = 0; i < size; i++)
+        batch.Values[i] = batch.Lows[i] + batch.Spans[i] * std::min(1., batch.Positions[i] / batch.Shapes[i]);
+}
+
+///
+/// \brief WaveformGenerator::noise
+/// \param batch
+///
+void WaveformGenerator::noise(Batch& batch) const
+{
+    // Box-Muller gives two normal samples per pair of uniform ones;
+    // the range is taken as +/-3 sigma around its middle
+    auto rnd = QRandomGenerator::global();
+    const int size = batch.Tags.size();
+    for(int i = 0; i < size; i += 2)
+    {
+        const double r = std::sqrt(-2. * std::log(1. - rnd->generateDouble()));
+        const double a = TwoPi * rnd->generateDouble();
+        const double z[2] = { r * std::cos(a), r * std::sin(a) };
+
+        for(int j = 0; j < 2 && i + j < size; j++)
+        {
+            const double low = batch.Lows[i + j];
+            const double span = batch.Spans[i + j];
+            batch.Values[i + j] = qBound(low, low + span / 2. + z[j] * span / 6., low + span);
+        }
+    }
+}
+
+///
+/// \brief WaveformGenerator::profile
+/// \param batch
+///
+void WaveformGenerator::profile(Batch& batch) const
+{
+    const int size = batch.Tags.size();
+    for(int i = 0; i < size; i++)
+    {
+        const auto& points = *batch.Profiles[i];
+        if(points.isEmpty())
+        {
+            batch.Values[i] = 0.;
+            continue;
+        }
+
+        const double t = batch.Positions[i];
+        const auto it = std::upper_bound(points.cbegin(), points.cend(), t, [](double x, const QPointF& p) {
+            return x < p.x();
+        });
+
+        if(it == points.cbegin())
+            batch.Values[i] = it->y();
+        else if(it == points.cend())
+            batch.Values[i] = points.last().y();
+        else
+        {
+            const auto& p0 = *(it - 1);
+            const auto& p1 = *it;
+            const double dx = p1.x() - p0.x();
+            batch.Values[i] = dx > 0 ? p0.y() + (p1.y() - p0.y()) * (t - p0.x()) / dx : p1.y();
+        }
+    }
+}
+
+///
+/// \brief WaveformGenerator::loadProfile
+/// \param filename CSV file with a time in msec and a value on each line
+/// \return the profile points in time order, empty if the file holds none
+///
+QVector<QPointF> WaveformGenerator::loadProfile(const QString& filename)
+{
+    QVector<QPointF> points;
+
+    QFile file(filename);
+    if(!file.open(QFile::ReadOnly | QFile::Text))
+        return points;
+
+    const QRegularExpression separators("[,;\\t]");
+
+    QTextStream ts(&file);
+    while(!ts.atEnd())
+    {
+        const auto line = ts.readLine().trimmed();
+        const auto fields = line.split(separators);
+        if(fields.size() < 2)
+            continue;
+
+        // header lines and anything else that does not parse are skipped
+        bool okTime, okValue;
+        const double time = fields[0].trimmed().toDouble(&okTime);
+        const double value = fields[1].trimmed().toDouble(&okValue);
+        if(!okTime || !okValue || time < 0)
+            continue;
+
+        if(!points.isEmpty() && time < points.last().x())
+            continue;
+
+        points.push_back({ time, value });
+    }
+
+    return points;
+}
@@ -0,0 +1,56 @@
+#ifndef WAVEFORMGENERATOR_H
+#define WAVEFORMGENERATOR_H
+
+#include "modbussimulationparams.h"
+
+///
+/// \brief The WaveformGenerator class evaluates the waveform points that fall due on one tick, a shape at a time
+///
+class WaveformGenerator
+{
+public:
+    void add(int tag, SimulationMode mode, const WaveformSimulationParams& params, quint64 time);
+    void generate();
+    void clear();
+
+    template<typename Func>
+    void forEach(Func&& func) const
+    {
+        for(auto&& batch : _batches)
+        {
+            for(int i = 0; i < batch.Tags.size(); i++)
+                func(batch.Tags[i], batch.Values[i]);
+        }
+    }
+
+    static QVector<QPointF> loadProfile(const QString& filename);
+
+private:
+    ///
+    /// \brief The Batch struct holds the points of one shape column by column
+    ///
+    struct Batch
+    {
+        QVector<int> Tags;
+        QVector<double> Positions;
+        QVector<double> Lows;
+        QVector<double> Spans;
+        QVector<double> Shapes;
+        QVector<const QVector<QPointF>*> Profiles;
+        QVector<double> Values;
+    };
+
+    static const int Shapes = int(SimulationMode::Profile) - int(SimulationMode::Sine) + 1;
+
+    void sine(Batch& batch) const;
+    void triangle(Batch& batch) const;
+    void square(Batch& batch) const;
+    void ramp(Batch& batch) const;
+    void noise(Batch& batch) const;
+    void profile(Batch& batch) const;
+
+private:
+    Batch _batches[Shapes];
+};
+
+#endif // WAVEFORMGENERATOR_H